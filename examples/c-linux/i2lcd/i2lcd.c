@@ -312,7 +312,9 @@ void lcdPrint(t_I2Lcd *lcd, const char *string)
 	    continue;
 	} else
 	{
-	    command(lcd, SET_DDRAM_ADDRESS, lcd->ddramadr[row] + column);
+	    // address counter increments itself, set it only when row changes
+	    if (column == 0 || i == 0 || string[i - 1] == '\n')
+		command(lcd, SET_DDRAM_ADDRESS, lcd->ddramadr[row] + column);
 	    writeByte(lcd, c);
 	    column++;
 
@@ -338,12 +340,42 @@ void lcdPrint(t_I2Lcd *lcd, const char *string)
 void _lcdPrintf(t_I2Lcd *lcd, const char *fmt, ...)
 {
     va_list arg;
-    char buf[100];
 
     va_start(arg, fmt);
-    vsnprintf(buf, 100, fmt, arg);
+    vsnprintf((char *) lcd->buffer, sizeof(lcd->buffer), fmt, arg);
     va_end(arg);
-    lcdPrint(lcd, buf);
+    lcdPrint(lcd, (const char *) lcd->buffer);
+}
+
+int _lcdPrintField(t_I2Lcd *lcd, uint8_t column, uint8_t row, uint8_t width, const char *fmt, ...)
+{
+    va_list arg;
+    char *field;
+    size_t offset, size;
+    int n;
+
+    if (row >= lcd->rows || column >= lcd->cols)
+	return 0;
+    if (width > lcd->cols - column)
+	width = lcd->cols - column;
+
+    // rows of buffer are contiguous, terminating zero may land in the next one
+    field = (char *) lcd->buffer[row] + column;
+    offset = field - (char *) lcd->buffer;
+    size = offset + width < sizeof(lcd->buffer) ? width + 1 : width;
+
+    va_start(arg, fmt);
+    n = vsnprintf(field, size, fmt, arg);
+    va_end(arg);
+    if (n < 0)
+	n = 0;
+    if (n < width)
+	memset(field + n, ' ', width - n);
+
+    command(lcd, SET_DDRAM_ADDRESS, lcd->ddramadr[row] + column);
+    writeBlock(lcd, field, width);
+    command(lcd, SET_DDRAM_ADDRESS, lcd->ddramadr[lcd->row] + lcd->column);
+    return n;
 }
 
 void lcdSetGC(t_I2Lcd *lcd, uint8_t chr, const uint8_t *bitmap)
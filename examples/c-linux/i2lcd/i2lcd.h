@@ -118,6 +118,24 @@ typedef struct s_i2lcd {
 void _lcdPrintf(t_I2Lcd *lcd, const char *fmt, ...) __attribute__((format (printf, 2, 3)));
 #define lcdPrintf(lcd, fmt, ...) _lcdPrintf(lcd, fmt, ##__VA_ARGS__)
 
+/**
+ * @brief Function formats printf(...) style into fixed width field of a row.
+ * Text is formatted straight into the row of lcd->buffer, cut at the field
+ * width or filled up with spaces, and sent with single DDRAM address.
+ * Use printf field widths, like "%6.1f", for numbers which keep their place.
+ * Cursor position doesn't change.
+ * @param *lcd addres of t_I2Lcd structure
+ * @param column first column of the field
+ * @param row row of the field
+ * @param width field width, clipped at the end of the row
+ * @param *fmt format string
+ * @param ... optional parameters, when fmt expect additional values
+ * @return number of characters formatted, before cutting or filling
+ */
+int _lcdPrintField(t_I2Lcd *lcd, uint8_t column, uint8_t row, uint8_t width, const char *fmt, ...)
+    __attribute__((format (printf, 5, 6)));
+#define lcdPrintField(lcd, column, row, width, fmt, ...) _lcdPrintField(lcd, column, row, width, fmt, ##__VA_ARGS__)
+
 void getSize(t_DisplayType type, uint8_t *columns, uint8_t *rows);
 void openI2LCD2(t_I2Lcd *lcd, uint8_t bus, uint8_t address, uint8_t columns, uint8_t rows);
 
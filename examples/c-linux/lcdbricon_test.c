@@ -22,8 +22,7 @@ void shandler(int signo)
 void brght(t_I2Lcd *lcd, uint8_t v)
 {
     if(quit) return;
-    lcdSetCursor(lcd, 0, 0);
-    lcdPrintf(lcd, "Brightness 0x%02X", v);
+    lcdPrintField(lcd, 0, 0, lcd->cols, "Brightness 0x%02X", v);
     lcdSetBacklight(lcd, v);
     usleep(50000);
 }
@@ -32,8 +31,7 @@ void brght(t_I2Lcd *lcd, uint8_t v)
 void ctrst(t_I2Lcd *lcd, uint8_t v)
 {
     if(quit) return;
-    lcdSetCursor(lcd, 0, 1);
-    lcdPrintf(lcd, "Contrast 0x%02X\x02", v);
+    lcdPrintField(lcd, 0, 1, lcd->cols, "Contrast 0x%02X\x02", v);
     lcdSetContrast(lcd, v);
     usleep(50000);
 }
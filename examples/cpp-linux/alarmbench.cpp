@@ -0,0 +1,89 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <buspool.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Latency from alarm() call to alarm text on the display, while
+ * background thread keeps redrawing whole 20x4 display on simulated
+ * 100 kHz bus. Alarm is sent in normal lane, queued behind background
+ * redraw, and in high lane, going out at next HD44780 operation.
+ * At the end display content is compared with scheduler's screen copy,
+ * to check interrupted redraws resumed at the right address.
+ *
+ * usage: alarmbench [alarms]
+ */
+
+static std::atomic<bool> running;
+
+static void _background(BusPool *pool)
+{
+    FrameBuffer frame(20, 4);
+    unsigned n = 0;
+
+    while (running)
+    {
+	frame.clear('A' + n++ % 26);
+	pool->submit(0, frame)->wait();
+    }
+}
+
+static double _alarm(BusPool &pool, t_Priority priority, unsigned n)
+{
+    steady_clock::time_point start = steady_clock::now();
+    char text[24];
+
+    snprintf(text, sizeof(text), "ALARM %04u", n);
+    pool.print(0, 5, 1, text, priority)->wait();
+    return duration<double>(steady_clock::now() - start).count() * 1000;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned alarms = argc > 1 ? atoi(argv[1]) : 100;
+    const char *names[PRIORITIES] = {"normal", "high"};
+    std::vector<double> latency;
+    unsigned i, p, row, bad = 0;
+    SimBus bus(100000);
+    I2Lcd lcd(bus, 0x20, D20x4);
+    BusPool pool;
+
+    lcd.power(POWERON);
+    pool.addBus(bus);
+    pool.attach(0, lcd);
+
+    running = true;
+    std::thread background(_background, &pool);
+
+    printf("lane     p50 ms  p99 ms  max ms\n");
+    for (p = 0; p < PRIORITIES; p++)
+    {
+	latency.clear();
+	for (i = 0; i < alarms; i++)
+	{
+	    std::this_thread::sleep_for(microseconds(2000 + rand() % 20000));
+	    latency.push_back(_alarm(pool, (t_Priority) p, i));
+	}
+	std::sort(latency.begin(), latency.end());
+	printf("%-7s %7.2f %7.2f %7.2f\n", names[p], latency[latency.size() / 2],
+	    latency[latency.size() * 99 / 100], latency.back());
+    }
+
+    running = false;
+    background.join();
+    pool.wait();
+    for (row = 0; row < 4; row++)
+	if (bus.visible(0x20, D20x4, row) != lcd.getScreen().text(row))
+	    bad++;
+    printf("rows differing from screen copy: %u, violations: %lu\n", bad, bus.module(0x20).violations);
+}
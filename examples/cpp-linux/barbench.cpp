@@ -0,0 +1,51 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <bargraph.h>
+
+using namespace i2lcd;
+
+/**
+ * VU meter on 20x4 display on simulated 100 kHz bus: horizontal bar of
+ * 20 cells and vertical bar of 4 cells follow slowly changing level.
+ * Incremental update is compared with redrawing whole bar every frame.
+ * Bus time per frame should stay well below 50 ms of 20 Hz refresh.
+ *
+ * usage: barbench [frames]
+ */
+
+int main(int argc, char **argv)
+{
+    unsigned frames = argc > 1 ? atoi(argv[1]) : 200;
+    t_BarDirection directions[] = {BAR_HORIZONTAL, BAR_VERTICAL};
+    unsigned d, i, mode, value;
+    SimBus bus(100000);
+    I2Lcd lcd(bus, 0x20, D20x4);
+
+    lcd.power(POWERON);
+    printf("bar         mode         cells/frame  bytes/frame  bus ms/frame\n");
+    for (d = 0; d < 2; d++)
+	for (mode = 0; mode < 2; mode++)
+	{
+	    BarGraph bar(lcd, 0, d ? 3 : 0, d ? 4 : 20, directions[d]);
+	    unsigned long cells;
+
+	    lcd.clear();
+	    bar.set(0);
+	    bus.resetCounters();
+	    cells = bar.getCells();
+	    for (i = 0; i < frames; i++)
+	    {
+		value = (unsigned) ((sin(i * 0.15) * 0.4 + 0.5 + sin(i * 1.7) * 0.05) * bar.getSteps());
+		if (mode)
+		    bar.redraw();
+		bar.set(value);
+	    }
+	    printf("%-11s %-11s %12.2f %12.1f %13.2f\n", d ? "vertical" : "horizontal", mode ? "full" : "incremental",
+		(double) (bar.getCells() - cells) / frames, (double) bus.getBytes() / frames,
+		bus.getWireTime() / 1000000.0 / frames);
+	}
+}
@@ -0,0 +1,117 @@
+#include <cstring>
+
+#include <bargraph.h>
+
+using namespace i2lcd;
+
+#define FULL	((char) 0xff)
+#define EMPTY	' '
+
+/**
+ * @brief BarGraph class constructor
+ *
+ * @param display
+ * @param column left column
+ * @param row left row of horizontal bar, bottom row of vertical bar
+ * @param length cells of the bar
+ * @param direction BAR_HORIZONTAL or BAR_VERTICAL
+ * @param slot first CGRAM slot used for partial cells
+ **/
+BarGraph::BarGraph(I2Lcd &display, uint8_t column, uint8_t row, uint8_t length, t_BarDirection direction,
+    uint8_t slot) : lcd(display), column(column), row(row), direction(direction), slot(slot & 0x07),
+    valid(false), loaded(false), written(0)
+{
+    int space = direction == BAR_HORIZONTAL ? lcd.columns() - column : row + 1;
+
+    if (column >= lcd.columns() || row >= lcd.rows())
+	this->length = 0;
+    else
+	this->length = length < space ? length : space;
+    if (this->length > BAR_MAX_CELLS)
+	this->length = BAR_MAX_CELLS;
+}
+
+/**
+ * @brief Number of steps of whole bar, largest value of set()
+ **/
+unsigned BarGraph::getSteps(void) const
+{
+    return length * (direction == BAR_HORIZONTAL ? BAR_HSTEPS : BAR_VSTEPS);
+}
+
+/**
+ * @brief Upload partial cell glyphs. Called by first set(), call again
+ * when something else used the slots meanwhile.
+ **/
+void BarGraph::load(void)
+{
+    char bitmap[8];
+    uint8_t i, r, parts;
+
+    parts = direction == BAR_HORIZONTAL ? BAR_HSTEPS - 1 : BAR_VSTEPS - 1;
+    for (i = 0; i < parts; i++)
+    {
+	for (r = 0; r < 8; r++)
+	    if (direction == BAR_HORIZONTAL)
+		bitmap[r] = (0x1f << (4 - i)) & 0x1f;
+	    else
+		bitmap[r] = r >= 7 - i ? 0x1f : 0x00;
+	lcd.setGC((slot + i) & 0x07, bitmap);
+    }
+    loaded = true;
+}
+
+/**
+ * @brief Helper returning character of cell for given value.
+ * This method is private
+ **/
+char BarGraph::_cell(unsigned value, uint8_t index) const
+{
+    unsigned steps = direction == BAR_HORIZONTAL ? BAR_HSTEPS : BAR_VSTEPS;
+    unsigned start = index * steps;
+
+    if (value >= start + steps)
+	return FULL;
+    if (value <= start)
+	return EMPTY;
+    return (slot + value - start - 1) & 0x07;
+}
+
+/**
+ * @brief Show value, only changed cells are written
+ *
+ * @param value 0 to getSteps(), larger values show full bar
+ **/
+void BarGraph::set(unsigned value)
+{
+    char next[BAR_MAX_CELLS];
+    uint8_t i, first;
+
+    if (!length)
+	return;
+    if (!loaded)
+	load();
+    for (i = 0; i < length; i++)
+	next[i] = _cell(value, i);
+
+    for (i = 0; i < length; i++)
+    {
+	if (valid && next[i] == cells[i])
+	    continue;
+	if (direction == BAR_VERTICAL)
+	{
+	    lcd.setCursor(column, row - i);
+	    lcd.print(string(1, next[i]));
+	    written++;
+	    continue;
+	}
+	first = i;
+	while (i + 1 < length && (!valid || next[i + 1] != cells[i + 1]))
+	    i++;
+	lcd.setCursor(column + first, row);
+	lcd.print(string(&next[first], i - first + 1));
+	written += i - first + 1;
+    }
+    memcpy(cells, next, length);
+    valid = true;
+}
@@ -0,0 +1,69 @@
+#ifndef __BARGRAPH_H__
+#define __BARGRAPH_H__
+
+#include <cstdint>
+
+#include <i2lcd.h>
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+#define BAR_HSTEPS	5
+#define BAR_VSTEPS	8
+#define BAR_MAX_CELLS	FB_MAX_COLUMNS
+
+/**
+ * @brief Bar direction, horizontal bars grow to the right,
+ * vertical bars grow up from the bottom row
+ */
+enum t_BarDirection {
+    BAR_HORIZONTAL,
+    BAR_VERTICAL,
+};
+
+/**
+ * @class BarGraph
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Bar graph with resolution of one pixel column or row.
+ *
+ * Cell is 5 steps wide or 8 steps tall. Full cells are drawn with
+ * 0xff block of character ROM, partially filled boundary cell with one
+ * of user characters, so horizontal bar takes 4 CGRAM slots and vertical
+ * bar takes 7, starting at given slot. set() keeps cells the display
+ * shows and writes only cells which changed, usually just the boundary
+ * cell, horizontal run of changed cells goes in one print().
+ *
+ */
+class BarGraph
+{
+    private:
+	I2Lcd &lcd;
+	uint8_t column;
+	uint8_t row;
+	uint8_t length;
+	t_BarDirection direction;
+	uint8_t slot;
+	char cells[BAR_MAX_CELLS];
+	bool valid;
+	bool loaded;
+	unsigned long written;
+
+	char _cell(unsigned value, uint8_t index) const;
+
+    public:
+	BarGraph(I2Lcd &display, uint8_t column, uint8_t row, uint8_t length,
+	    t_BarDirection direction = BAR_HORIZONTAL, uint8_t slot = 0);
+
+	void load(void);
+	void set(unsigned value);
+	void redraw(void) { valid = false; };
+
+	unsigned getSteps(void) const;
+	unsigned long getCells(void) const { return written; };
+};
+
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <bigdigits.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Counter shown with 2 and 3 rows tall digits on 20x4 display on
+ * simulated 100 kHz bus. Incremental update, which only draws changed
+ * digits, is compared with redrawing the whole number every time.
+ *
+ * usage: bigbench [updates]
+ */
+
+int main(int argc, char **argv)
+{
+    unsigned updates = argc > 1 ? atoi(argv[1]) : 50;
+    unsigned heights[] = {2, 3};
+    unsigned h, i, mode;
+    unsigned long changed;
+    double t;
+    SimBus bus(100000);
+    I2Lcd lcd(bus, 0x20, D20x4);
+
+    lcd.power(POWERON);
+    printf("rows  mode         ms/update  digits/update  ms/changed digit  transactions/update\n");
+    for (h = 0; h < 2; h++)
+	for (mode = 0; mode < 2; mode++)
+	{
+	    BigDigits big(lcd, 0, 0, 5, heights[h]);
+
+	    lcd.clear();
+	    big.show(12340L);
+	    bus.resetCounters();
+	    changed = big.getCells();
+	    steady_clock::time_point start = steady_clock::now();
+	    for (i = 1; i <= updates; i++)
+	    {
+		if (mode)
+		    big.redraw();
+		big.show(12340L + i * 7);
+	    }
+	    t = duration<double>(steady_clock::now() - start).count() * 1000;
+	    changed = (big.getCells() - changed) / (BIGDIGIT_WIDTH * heights[h]);
+	    printf("%4u  %-11s %10.2f  %13.2f  %16.2f  %19.1f\n", heights[h], mode ? "full" : "incremental",
+		t / updates, (double) changed / updates, t / changed, (double) bus.getTransactions() / updates);
+	}
+}
@@ -0,0 +1,170 @@
+#include <cstdio>
+
+#include <bigdigits.h>
+
+using namespace i2lcd;
+
+/*
+ * Segment glyphs: rounded corners, upper, lower and both bars.
+ */
+#define LT	0
+#define UB	1
+#define RT	2
+#define LL	3
+#define LB	4
+#define LR	5
+#define UMB	6
+#define LMB	7
+#define FULL	((char) 0xff)
+#define NONE	' '
+
+static const char glyphs[8][8] = {
+    {0x07, 0x0f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f},
+    {0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x1c, 0x1e, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f},
+    {0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x0f, 0x07},
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f, 0x1f},
+    {0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1e, 0x1c},
+    {0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x1f, 0x1f},
+    {0x1f, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x1f, 0x1f},
+};
+
+/*
+ * Characters in order "0123456789- .", rows of 3 cells.
+ */
+static const char font2[13][2][BIGDIGIT_WIDTH] = {
+    {{LT, UB, RT}, {LL, LB, LR}},
+    {{UB, RT, NONE}, {LB, FULL, LB}},
+    {{UMB, UMB, RT}, {LL, LB, LB}},
+    {{UMB, UMB, RT}, {LMB, LMB, LR}},
+    {{LL, LB, FULL}, {NONE, NONE, FULL}},
+    {{FULL, UMB, UMB}, {LMB, LMB, LR}},
+    {{LT, UMB, UMB}, {LL, LMB, LR}},
+    {{UB, UB, RT}, {NONE, NONE, FULL}},
+    {{LT, UMB, RT}, {LL, LMB, LR}},
+    {{LT, UMB, RT}, {LMB, LMB, LR}},
+    {{LB, LB, LB}, {NONE, NONE, NONE}},
+    {{NONE, NONE, NONE}, {NONE, NONE, NONE}},
+    {{NONE, NONE, NONE}, {NONE, LB, NONE}},
+};
+
+static const char font3[13][3][BIGDIGIT_WIDTH] = {
+    {{LT, UB, RT}, {FULL, NONE, FULL}, {LL, LB, LR}},
+    {{UB, RT, NONE}, {NONE, FULL, NONE}, {LB, FULL, LB}},
+    {{UB, UB, RT}, {LT, LB, LR}, {LL, LB, LB}},
+    {{UB, UB, RT}, {NONE, LB, FULL}, {LB, LB, LR}},
+    {{FULL, NONE, FULL}, {LL, LB, FULL}, {NONE, NONE, FULL}},
+    {{FULL, UB, UB}, {UB, UB, RT}, {LB, LB, LR}},
+    {{LT, UB, UB}, {FULL, UB, RT}, {LL, LB, LR}},
+    {{UB, UB, RT}, {NONE, NONE, FULL}, {NONE, NONE, FULL}},
+    {{LT, UB, RT}, {FULL, UMB, FULL}, {LL, LB, LR}},
+    {{LT, UB, RT}, {LL, LB, FULL}, {LB, LB, LR}},
+    {{NONE, NONE, NONE}, {UMB, UMB, UMB}, {NONE, NONE, NONE}},
+    {{NONE, NONE, NONE}, {NONE, NONE, NONE}, {NONE, NONE, NONE}},
+    {{NONE, NONE, NONE}, {NONE, NONE, NONE}, {NONE, LB, NONE}},
+};
+
+/**
+ * @brief Helper returning font index of character
+ */
+static int _index(char c)
+{
+    if (c >= '0' && c <= '9')
+	return c - '0';
+    if (c == '-')
+	return 10;
+    if (c == '.')
+	return 12;
+    return 11;
+}
+
+/**
+ * @brief BigDigits class constructor
+ *
+ * @param display
+ * @param column first column of the number
+ * @param row top row of the number
+ * @param digits number of digit positions
+ * @param height 2 or 3 rows
+ **/
+BigDigits::BigDigits(I2Lcd &display, uint8_t column, uint8_t row, uint8_t digits, uint8_t height) : lcd(display),
+    column(column), row(row), digits(digits), height(height == 3 ? 3 : 2), loaded(false), cells(0)
+{
+}
+
+/**
+ * @brief Upload segment glyphs. Called by first show(), call again
+ * when something else used CGRAM meanwhile.
+ **/
+void BigDigits::load(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+	lcd.setGC(i, glyphs[i]);
+    loaded = true;
+}
+
+/**
+ * @brief Forget what is on the display, next show() draws every digit
+ **/
+void BigDigits::redraw(void)
+{
+    shown.clear();
+}
+
+/**
+ * @brief Helper drawing one digit position. This method is private
+ **/
+void BigDigits::_draw(uint8_t position, char c)
+{
+    int index = _index(c);
+    uint8_t r;
+
+    for (r = 0; r < height; r++)
+    {
+	lcd.setCursor(column + position * BIGDIGIT_PITCH, row + r);
+	if (height == 3)
+	    lcd.print(string(font3[index][r], BIGDIGIT_WIDTH));
+	else
+	    lcd.print(string(font2[index][r], BIGDIGIT_WIDTH));
+	cells += BIGDIGIT_WIDTH;
+    }
+}
+
+/**
+ * @brief Show text right aligned in digit positions.
+ * Only positions which changed are drawn.
+ *
+ * @param text digits, ' ', '-' and '.'
+ **/
+void BigDigits::show(const string &text)
+{
+    string next(digits, ' ');
+    uint8_t i;
+
+    if (!loaded)
+	load();
+    if (text.size() >= digits)
+	next = text.substr(text.size() - digits);
+    else
+	next.replace(digits - text.size(), text.size(), text);
+
+    for (i = 0; i < digits; i++)
+	if (shown.size() != digits || _index(shown[i]) != _index(next[i]))
+	    _draw(i, next[i]);
+    shown = next;
+}
+
+/**
+ * @brief Show number right aligned
+ *
+ * @param value
+ **/
+void BigDigits::show(long value)
+{
+    char buf[24];
+
+    snprintf(buf, sizeof(buf), "%ld", value);
+    show(string(buf));
+}
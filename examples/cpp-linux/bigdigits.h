@@ -0,0 +1,56 @@
+#ifndef __BIGDIGITS_H__
+#define __BIGDIGITS_H__
+
+#include <cstdint>
+#include <string>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+#define BIGDIGIT_WIDTH	3
+#define BIGDIGIT_PITCH	4
+
+/**
+ * @class BigDigits
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Large digits, 2 or 3 rows tall, drawn from 8 segment glyphs.
+ *
+ * Segment glyphs are uploaded once with I2Lcd::setGC() and occupy whole
+ * CGRAM, both heights share them. Every digit is 3 columns wide with
+ * one column gap. show() remembers what is on the display and only
+ * rewrites digits that changed, each with setCursor() and print() per row.
+ * Digits, space, '-' and '.' can be shown; other characters show blank.
+ *
+ */
+class BigDigits
+{
+    private:
+	I2Lcd &lcd;
+	uint8_t column;
+	uint8_t row;
+	uint8_t digits;
+	uint8_t height;
+	string shown;
+	bool loaded;
+	unsigned long cells;
+
+	void _draw(uint8_t position, char c);
+
+    public:
+	BigDigits(I2Lcd &display, uint8_t column, uint8_t row, uint8_t digits, uint8_t height = 2);
+
+	void load(void);
+	void show(const string &text);
+	void show(long value);
+	void redraw(void);
+
+	uint8_t getDigits(void) const { return digits; };
+	unsigned long getCells(void) const { return cells; };
+};
+
+};
+
+#endif
@@ -0,0 +1,287 @@
+#include <pthread.h>
+#include <sched.h>
+
+#include <buspool.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Mark one frame as shown
+ **/
+void Completion::done(void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (remaining && !--remaining)
+	cond.notify_all();
+}
+
+/**
+ * @brief Check if all frames are shown
+ *
+ * @return true if nothing is left
+ **/
+bool Completion::finished(void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return !remaining;
+}
+
+/**
+ * @brief Wait until all frames are shown
+ **/
+void Completion::wait(void)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (remaining)
+	cond.wait(guard);
+}
+
+/**
+ * @brief BusPool class destructor. Queued frames are shown
+ * before workers exit, buses opened by pool are closed.
+ **/
+BusPool::~BusPool()
+{
+    size_t i;
+
+    for (i = 0; i < workers.size(); i++)
+    {
+	{
+	    std::lock_guard<std::mutex> guard(workers[i]->lock);
+	    workers[i]->stop = true;
+	}
+	workers[i]->cond.notify_one();
+	workers[i]->thread.join();
+	delete workers[i]->sched;
+	delete workers[i];
+    }
+}
+
+/**
+ * @brief Open /dev/i2c-N and start its worker
+ *
+ * @param busn bus number
+ * @param cpu CPU to run the worker on, -1 for any
+ * @return bus index used by attach()
+ **/
+unsigned BusPool::addBus(uint8_t busn, int cpu)
+{
+    return _start(new BusScheduler(busn), cpu);
+}
+
+/**
+ * @brief Start worker for already opened bus
+ *
+ * @param busi bus interface
+ * @param cpu CPU to run the worker on, -1 for any
+ * @return bus index used by attach()
+ **/
+unsigned BusPool::addBus(I2CBus &busi, int cpu)
+{
+    return _start(new BusScheduler(busi), cpu);
+}
+
+/**
+ * @brief Helper creating worker thread and pinning it
+ **/
+unsigned BusPool::_start(BusScheduler *sched, int cpu)
+{
+    t_Worker *w = new t_Worker;
+    cpu_set_t set;
+
+    w->sched = sched;
+    w->arrived = false;
+    w->stop = false;
+    w->thread = std::thread(_run, w);
+    workers.push_back(w);
+    if (cpu >= 0)
+    {
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (pthread_setaffinity_np(w->thread.native_handle(), sizeof(set), &set))
+	    throw tPoolAffinity;
+    }
+    return workers.size() - 1;
+}
+
+/**
+ * @brief Attach display to bus worker. Display must be created
+ * on getBus(bus) and powered on.
+ *
+ * @param bus bus index
+ * @param lcd display
+ * @return display number used by submit()
+ **/
+unsigned BusPool::attach(unsigned bus, I2Lcd &lcd)
+{
+    t_Target t;
+
+    t.worker = bus;
+    t.display = workers[bus]->sched->attach(lcd);
+    targets.push_back(t);
+    return targets.size() - 1;
+}
+
+/**
+ * @brief Helper handing one job to display's worker
+ **/
+void BusPool::_queue(t_Job &job)
+{
+    t_Worker *w = workers[targets[job.display].worker];
+    bool wake;
+
+    job.display = targets[job.display].display;
+    {
+	std::lock_guard<std::mutex> guard(w->lock);
+	wake = w->jobs.empty();
+	w->jobs.push_back(job);
+	w->arrived = true;
+    }
+    if (wake)
+	w->cond.notify_one();
+}
+
+/**
+ * @brief Show frame on one display
+ *
+ * @param display display number
+ * @param frame content
+ * @param priority lane
+ * @return completion handle
+ **/
+std::shared_ptr<Completion> BusPool::submit(unsigned display, const FrameBuffer &frame, t_Priority priority)
+{
+    std::shared_ptr<Completion> completion(new Completion(1));
+    t_Job job = { display, priority, false, 0, 0, string(), frame, completion };
+
+    _queue(job);
+    return completion;
+}
+
+/**
+ * @brief Fan-out: show frames on many displays at once.
+ * Frame at index i goes to display i, NULL entries are skipped.
+ *
+ * @param frames content for every display
+ * @param priority lane
+ * @return completion handle, done when all displays are updated
+ **/
+std::shared_ptr<Completion> BusPool::submit(const std::vector<const FrameBuffer*> &frames, t_Priority priority)
+{
+    std::shared_ptr<Completion> completion;
+    unsigned count = 0;
+    size_t i;
+
+    for (i = 0; i < frames.size(); i++)
+	if (frames[i])
+	    count++;
+    completion.reset(new Completion(count));
+    for (i = 0; i < frames.size(); i++)
+	if (frames[i])
+	{
+	    t_Job job = { (unsigned) i, priority, false, 0, 0, string(), *frames[i], completion };
+
+	    _queue(job);
+	}
+    return completion;
+}
+
+/**
+ * @brief Print text at given position, as BusScheduler::print()
+ *
+ * @param display display number
+ * @param column
+ * @param row
+ * @param text
+ * @param priority lane
+ * @return completion handle
+ **/
+std::shared_ptr<Completion> BusPool::print(unsigned display, uint8_t column, uint8_t row, const string &text, t_Priority priority)
+{
+    std::shared_ptr<Completion> completion(new Completion(1));
+    t_Job job = { display, priority, true, column, row, text, FrameBuffer(), completion };
+
+    _queue(job);
+    return completion;
+}
+
+/**
+ * @brief Wait until every worker shows all queued frames
+ **/
+void BusPool::wait(void)
+{
+    std::shared_ptr<Completion> completion(new Completion(workers.size()));
+    size_t i;
+
+    for (i = 0; i < workers.size(); i++)
+    {
+	t_Job job = { NO_DISPLAY, PRIORITY_NORMAL, false, 0, 0, string(), FrameBuffer(), completion };
+
+	std::lock_guard<std::mutex> guard(workers[i]->lock);
+	workers[i]->jobs.push_back(job);
+	workers[i]->arrived = true;
+	workers[i]->cond.notify_one();
+    }
+    completion->wait();
+}
+
+/**
+ * @brief Worker loop. Takes all waiting jobs at once, so frames of many
+ * displays overlap on the bus, and only the newest frame of a display
+ * is diffed when several arrived meanwhile. Scheduler is interrupted
+ * whenever new jobs arrive, they are queued and sorted into lanes
+ * before next operation goes out.
+ **/
+void BusPool::_run(t_Worker *w)
+{
+    std::vector<t_Job> jobs, active;
+    BusScheduler &sched = *w->sched;
+    size_t i, j;
+
+    for (;;)
+    {
+	{
+	    std::unique_lock<std::mutex> guard(w->lock);
+
+	    while (w->jobs.empty() && active.empty() && !w->stop)
+		w->cond.wait(guard);
+	    if (w->jobs.empty() && active.empty())
+		return;
+	    jobs.swap(w->jobs);
+	    w->arrived = false;
+	}
+
+	for (i = 0; i < jobs.size(); i++)
+	{
+	    if (jobs[i].display != NO_DISPLAY && jobs[i].print)
+		sched.print(jobs[i].display, jobs[i].column, jobs[i].row, jobs[i].text, jobs[i].priority);
+	    else if (jobs[i].display != NO_DISPLAY)
+	    {
+		for (j = i + 1; j < jobs.size(); j++)
+		    if (jobs[j].display == jobs[i].display && jobs[j].priority == jobs[i].priority && !jobs[j].print)
+			break;
+		if (j == jobs.size())
+		    sched.show(jobs[i].display, jobs[i].frame, jobs[i].priority);
+	    }
+	    active.push_back(jobs[i]);
+	}
+	jobs.clear();
+
+	do {
+	    for (i = 0; i < active.size(); )
+		if (active[i].display == NO_DISPLAY ? !sched.pending() : !sched.pending(active[i].display, active[i].priority))
+		{
+		    active[i].completion->done();
+		    active.erase(active.begin() + i);
+		} else
+		    i++;
+	    if (active.empty() || w->arrived)
+		break;
+	    if (!sched.step())
+		sched.wait();
+	} while (true);
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef __BUSPOOL_H__
+#define __BUSPOOL_H__
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include <i2lcd.h>
+#include <framebuffer.h>
+#include <scheduler.h>
+
+namespace i2lcd {
+
+#define NO_DISPLAY	0xffffffffu
+
+/**
+ * @class PoolAffinity
+ *
+ * @ingroup i2lcd
+ *
+ * @brief PoolAffinity Exception class thrown when bus worker can't be
+ *        pinned to requested CPU
+ *
+ *
+ */
+class PoolAffinity: public exception
+{
+} tPoolAffinity;
+
+/**
+ * @class Completion
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Handle of submitted frames, done when every frame is on its display.
+ *
+ */
+class Completion
+{
+    private:
+	std::mutex lock;
+	std::condition_variable cond;
+	unsigned remaining;
+
+    public:
+	Completion(unsigned count) : remaining(count) {};
+
+	void done(void);
+	bool finished(void);
+	void wait(void);
+};
+
+/**
+ * @class BusPool
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Worker thread per I2C bus, each running own BusScheduler.
+ *
+ * Displays on different buses are refreshed in parallel, so time needed
+ * to update a wall of displays is set by the slowest bus, not by the sum
+ * of all of them. Worker can be pinned to a CPU, keeping bus traffic
+ * away from cores doing other work.
+ *
+ * Buses and displays are added before first submit(). Displays are
+ * numbered across the pool in order of attach(). Frames are copied
+ * on submit, caller may reuse its buffers immediately. Display gets
+ * only cells changed since the frame it shows.
+ *
+ * Worker picks new jobs between HD44780 operations, so high priority
+ * job doesn't wait for background frames already on the way. Completion
+ * of a job is signalled when its display's lane drains.
+ *
+ */
+class BusPool
+{
+    private:
+	struct t_Job {
+	    unsigned display;
+	    t_Priority priority;
+	    bool print;
+	    uint8_t column;
+	    uint8_t row;
+	    string text;
+	    FrameBuffer frame;
+	    std::shared_ptr<Completion> completion;
+	};
+
+	struct t_Worker {
+	    BusScheduler *sched;
+	    std::thread thread;
+	    std::mutex lock;
+	    std::condition_variable cond;
+	    std::vector<t_Job> jobs;
+	    std::atomic<bool> arrived;
+	    bool stop;
+	};
+
+	struct t_Target {
+	    unsigned worker;
+	    unsigned display;
+	};
+
+	std::vector<t_Worker*> workers;
+	std::vector<t_Target> targets;
+
+	unsigned _start(BusScheduler *sched, int cpu);
+	void _queue(t_Job &job);
+	static void _run(t_Worker *worker);
+
+    public:
+	BusPool() {};
+	~BusPool();
+
+	unsigned addBus(uint8_t busn, int cpu = -1);
+	unsigned addBus(I2CBus &busi, int cpu = -1);
+	I2CBus &getBus(unsigned bus) { return workers[bus]->sched->getBus(); };
+	unsigned attach(unsigned bus, I2Lcd &lcd);
+	unsigned buses(void) const { return workers.size(); };
+	unsigned displays(void) const { return targets.size(); };
+
+	std::shared_ptr<Completion> submit(unsigned display, const FrameBuffer &frame, t_Priority priority = PRIORITY_NORMAL);
+	std::shared_ptr<Completion> submit(const std::vector<const FrameBuffer*> &frames, t_Priority priority = PRIORITY_NORMAL);
+	std::shared_ptr<Completion> print(unsigned display, uint8_t column, uint8_t row, const string &text, t_Priority priority = PRIORITY_NORMAL);
+	void wait(void);
+};
+
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <i2cbus.h>
+#include <simbus.h>
+#include <lcdcore.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * CPU cost of encoding characters of 20x4 frame into PCA9535 writes,
+ * in cycles per character (nanoseconds where there's no cycle counter).
+ * Both paths encode the same operations with lcdEncode(), so they record
+ * the same bytes and differ only in dispatch. BasicLcd<RecordBus> encodes
+ * into its buffer and hands all messages to the recorder at once, bound
+ * statically. Virtual path sends every operation through I2CBus interface
+ * as I2Lcd::strobe() does, one virtual transfer() per operation. Then
+ * BasicLcd<SimBus> shows the frame on simulated module.
+ *
+ * usage: corebench [frames]
+ */
+
+typedef LcdGeometry<D20x4> G;
+
+static const char *rows[4] = {"Header only BasicLcd", "templated on bus and", "geometry, operations", "encoded into buffers"};
+
+static uint64_t _ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Row encoded by lcdEncode() and sent operation by operation
+ * through virtual transfer()
+ */
+static void __attribute__((noinline)) _virtual(I2CBus &bus, uint8_t address, uint8_t base, int &rs, uint8_t ddaddress,
+    const char *text, unsigned len)
+{
+    uint8_t buf[LCDCORE_OPBYTES];
+    struct i2c_msg msg = {address, 0, 0, buf};
+    unsigned i;
+
+    msg.len = lcdEncode(buf, base, rs, false, (1 << SET_DDRAM_ADDRESS) | ddaddress) - buf;
+    bus.transfer(&msg, 1);
+    for (i = 0; i < len; i++)
+    {
+	msg.len = lcdEncode(buf, base, rs, true, text[i]) - buf;
+	bus.transfer(&msg, 1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned frames = argc > 1 ? atoi(argv[1]) : 100000;
+    uint8_t base = UD | BACKLIGHT_CS | CONTRAST_CS;
+    unsigned long bytes[2];
+    uint64_t start;
+    unsigned f, r;
+    RecordBus rec;
+    I2CBus *iface = &rec;
+    int rs = -1;
+
+    {
+	BasicLcd<RecordBus, G> lcd(rec, 0x20);
+
+	start = _ticks();
+	for (f = 0; f < frames; f++)
+	{
+	    rec.clear();
+	    for (r = 0; r < G::rows; r++)
+		lcd.put(0, r, rows[r]);
+	    lcd.flush();
+	}
+	printf("BasicLcd<RecordBus>   %6.1f per character, %lu bytes per frame\n",
+	    (double) (_ticks() - start) / frames / G::cells, bytes[0] = rec.getRecord().size());
+    }
+
+    /* hide dynamic type, so transfer() isn't devirtualized */
+    asm volatile("" : "+r" (iface));
+    start = _ticks();
+    for (f = 0; f < frames; f++)
+    {
+	rec.clear();
+	for (r = 0; r < G::rows; r++)
+	    _virtual(*iface, 0x20, base, rs, G::address(0, r), rows[r], strlen(rows[r]));
+    }
+    printf("I2CBus virtual        %6.1f per character, %lu bytes per frame\n",
+	(double) (_ticks() - start) / frames / G::cells, bytes[1] = rec.getRecord().size());
+
+    SimBus bus;
+    BasicLcd<SimBus, G> lcd(bus, 0x20);
+
+    lcd.power(true);
+    lcd.print<0, 0>(rows[0]);
+    lcd.print<0, 1>(rows[1]);
+    lcd.print<0, 2>(rows[2]);
+    lcd.print<0, 3>(rows[3]);
+    lcd.flush();
+    for (r = 0; r < G::rows; r++)
+	if (bus.visible(0x20, G::type, r) != rows[r])
+	    printf("row %u differs: |%s|\n", r, bus.visible(0x20, G::type, r).c_str());
+    printf("SimBus: %lu violations\n", bus.module(0x20).violations);
+    return 0;
+}
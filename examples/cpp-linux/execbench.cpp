@@ -0,0 +1,134 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <unistd.h>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <executor.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Multithreaded benchmark of bus contention. Every thread writes its own
+ * counter to its own cell, first by calling I2Lcd directly under its bus
+ * lock, then through LcdExecutor. For executor both submit latency seen
+ * by producers and drain throughput of the single writer are reported.
+ *
+ * usage: execbench [-S] [bus] [address] [operations per thread]
+ *
+ * -S runs on simulated 100 kHz bus instead of /dev/i2c-N.
+ */
+
+static double _direct(I2Lcd &lcd, unsigned threads, unsigned ops)
+{
+    std::vector<std::thread> t;
+    steady_clock::time_point start = steady_clock::now();
+    unsigned i;
+
+    for (i = 0; i < threads; i++)
+	t.push_back(std::thread([&lcd, i, ops] {
+	    unsigned n;
+	    for (n = 0; n < ops; n++)
+	    {
+		std::lock_guard<std::recursive_mutex> guard(lcd.busLock());
+		lcd.setCursor(i % lcd.columns(), 0);
+		lcd.print(to_string(n % 10));
+	    }
+	}));
+    for (i = 0; i < threads; i++)
+	t[i].join();
+
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+static double _executor(I2Lcd &lcd, unsigned threads, unsigned ops, double *submitns, double *maxns, double *batch)
+{
+    LcdExecutor exec(lcd);
+    std::vector<std::thread> t;
+    std::vector<double> total(threads), worst(threads);
+    steady_clock::time_point start = steady_clock::now();
+    unsigned i;
+
+    for (i = 0; i < threads; i++)
+	t.push_back(std::thread([&exec, &lcd, &total, &worst, i, ops] {
+	    unsigned n;
+	    double ns;
+	    for (n = 0; n < ops; n++)
+	    {
+		steady_clock::time_point s = steady_clock::now();
+		exec.printAt(i % lcd.columns(), 1 % lcd.rows(), to_string(n % 10));
+		ns = duration<double, std::nano>(steady_clock::now() - s).count();
+		total[i] += ns;
+		if (ns > worst[i])
+		    worst[i] = ns;
+	    }
+	}));
+    for (i = 0; i < threads; i++)
+	t[i].join();
+    exec.sync();
+
+    *submitns = 0;
+    *maxns = 0;
+    for (i = 0; i < threads; i++)
+    {
+	*submitns += total[i];
+	if (worst[i] > *maxns)
+	    *maxns = worst[i];
+    }
+    *submitns /= (double) threads * ops;
+    *batch = (double) exec.getOperations() / exec.getBatches();
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    std::unique_ptr<SimBus> sim;
+    std::unique_ptr<I2Lcd> display;
+    unsigned threads[] = {1, 2, 4, 8};
+    double t, submitns, maxns, batch;
+    bool simulated = false;
+    unsigned i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "S")) != -1)
+	switch (opt)
+	{
+	    case 'S': simulated = true; break;
+	    default:
+		fprintf(stderr, "usage: %s [-S] [bus] [address] [operations per thread]\n", argv[0]);
+		return 1;
+	}
+    argc -= optind;
+    argv += optind;
+
+    uint8_t bus = argc > 0 ? atoi(argv[0]) : 2;
+    uint8_t address = argc > 1 ? strtol(argv[1], NULL, 0) : 0x20;
+    unsigned ops = argc > 2 ? atoi(argv[2]) : 200;
+
+    if (simulated)
+    {
+	sim.reset(new SimBus(100000, bus));
+	display.reset(new I2Lcd(*sim, address, 16, 2));
+    } else
+	display.reset(new I2Lcd(bus, address, 16, 2, "/run"));
+    I2Lcd &lcd = *display;
+
+    lcd.power(POWERON);
+    lcd.clear();
+
+    printf("threads  direct ops/s  exec ops/s  submit avg ns  submit max ns  avg batch\n");
+    for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+    {
+	double d = _direct(lcd, threads[i], ops);
+	t = _executor(lcd, threads[i], ops, &submitns, &maxns, &batch);
+	printf("%7u  %12.1f  %10.1f  %13.1f  %13.1f  %9.2f\n", threads[i],
+	       threads[i] * ops / d, threads[i] * ops / t, submitns, maxns, batch);
+    }
+
+    lcd.power(POWEROFF);
+}
@@ -0,0 +1,241 @@
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include <cstring>
+#include <future>
+
+#include <executor.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief LcdExecutor class constructor.
+ * Starts executor thread, which becomes the only
+ * writer to the display.
+ *
+ * @param display LCD to drive
+ **/
+LcdExecutor::LcdExecutor(I2Lcd &display) : lcd(display), head(NULL), quit(false), batches(0), operations(0), errors(0)
+{
+    wakefd = eventfd(0, EFD_CLOEXEC);
+    worker = std::thread(&LcdExecutor::_run, this);
+}
+
+/**
+ * @brief LcdExecutor class destructor.
+ * Operations submitted before are executed,
+ * then executor thread is stopped.
+ **/
+LcdExecutor::~LcdExecutor()
+{
+    quit = true;
+    _wake();
+    worker.join();
+    close(wakefd);
+}
+
+/**
+ * @brief Wake up executor thread.
+ * This method is private
+ **/
+void LcdExecutor::_wake(void)
+{
+    uint64_t one = 1;
+
+    if (write(wakefd, &one, sizeof(one)) < 0) {};
+}
+
+/**
+ * @brief Execute list of operations in submission order
+ * under single bus lock. Posted pot moves are finished
+ * at the end of the batch.
+ * This method is private
+ *
+ * @param list operations in reverse submission order
+ **/
+void LcdExecutor::_execute(t_Node *list)
+{
+    t_Node *fifo = NULL, *n;
+
+    while (list)
+    {
+	n = list->next;
+	list->next = fifo;
+	fifo = list;
+	list = n;
+    }
+
+    std::lock_guard<std::recursive_mutex> guard(lcd.busLock());
+    while (fifo)
+    {
+	n = fifo->next;
+	try
+	{
+	    fifo->op(lcd);
+	} catch (std::exception &e)
+	{
+	    errors++;
+	}
+	operations++;
+	delete fifo;
+	fifo = n;
+    }
+    lcd.flushLevels();
+    batches++;
+}
+
+/**
+ * @brief Executor thread body.
+ * This method is private
+ **/
+void LcdExecutor::_run(void)
+{
+    uint64_t v;
+    t_Node *list;
+
+    for(;;)
+    {
+	list = head.exchange(NULL, std::memory_order_acquire);
+	if (list)
+	{
+	    _execute(list);
+	    continue;
+	}
+	lcd.flushLevels();
+	if (quit)
+	    break;
+	if (read(wakefd, &v, sizeof(v)) < 0) {};
+    }
+}
+
+/**
+ * @brief Submit operation for execution. Takes no lock.
+ * Executor thread is woken up only when it has nothing
+ * queued yet, so bursts cost one wakeup.
+ *
+ * @param op operation called with I2Lcd reference
+ **/
+void LcdExecutor::submit(t_Operation op)
+{
+    t_Node *n = new t_Node;
+
+    n->op = std::move(op);
+    n->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)) {};
+    if (n->next == NULL)
+	_wake();
+}
+
+/**
+ * @brief Wait until all operations submitted so far
+ * by calling thread are executed.
+ **/
+void LcdExecutor::sync(void)
+{
+    std::promise<void> done;
+    std::future<void> f = done.get_future();
+
+    submit([&done](I2Lcd &) { done.set_value(); });
+    f.wait();
+}
+
+/**
+ * @brief Queue print of string at current position
+ *
+ * @param value string to print
+ **/
+void LcdExecutor::print(const string &value)
+{
+    submit([value](I2Lcd &l) { l.print(value); });
+}
+
+/**
+ * @brief Queue print of string at given position.
+ * Cursor move and print are executed as one operation,
+ * so other threads can't put anything between them.
+ *
+ * @param column
+ * @param row
+ * @param value string to print
+ **/
+void LcdExecutor::printAt(uint8_t column, uint8_t row, const string &value)
+{
+    submit([column, row, value](I2Lcd &l) { l.setCursor(column, row); l.print(value); });
+}
+
+/**
+ * @brief Queue cursor move
+ *
+ * @param column
+ * @param row
+ **/
+void LcdExecutor::setCursor(uint8_t column, uint8_t row)
+{
+    submit([column, row](I2Lcd &l) { l.setCursor(column, row); });
+}
+
+/**
+ * @brief Queue graphical character definition.
+ * Bitmap is copied, so caller can reuse its buffer.
+ *
+ * @param character number
+ * @param bitmap 8 bytes of character bitmap
+ **/
+void LcdExecutor::setGC(uint8_t character, const char *bitmap)
+{
+    string b(bitmap, 8);
+
+    submit([character, b](I2Lcd &l) { l.setGC(character, b.data()); });
+}
+
+/**
+ * @brief Queue display clear
+ **/
+void LcdExecutor::clear(void)
+{
+    submit([](I2Lcd &l) { l.clear(); });
+}
+
+/**
+ * @brief Queue return home
+ **/
+void LcdExecutor::home(void)
+{
+    submit([](I2Lcd &l) { l.home(); });
+}
+
+/**
+ * @brief Request backlight level. Doesn't use the queue,
+ * wiper pulses ride along next batch.
+ *
+ * @param value
+ **/
+void LcdExecutor::setBacklight(uint8_t value)
+{
+    lcd.postBacklight(value);
+    _wake();
+}
+
+/**
+ * @brief Request contrast level. Doesn't use the queue,
+ * wiper pulses ride along next batch.
+ *
+ * @param value
+ **/
+void LcdExecutor::setContrast(uint8_t value)
+{
+    lcd.postContrast(value);
+    _wake();
+}
+
+/**
+ * @brief Request backlight and contrast levels at once.
+ *
+ * @param backlight
+ * @param contrast
+ **/
+void LcdExecutor::setLevels(uint8_t backlight, uint8_t contrast)
+{
+    lcd.postLevels(backlight, contrast);
+    _wake();
+}
@@ -0,0 +1,77 @@
+#ifndef __EXECUTOR_H__
+#define __EXECUTOR_H__
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <functional>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+/**
+ * @class LcdExecutor
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Thread-safe facade for I2Lcd with single writer thread.
+ *
+ * Any thread can submit operations, executor thread is the only one
+ * touching the bus. Submitting pushes operation on lock-free stack and
+ * wakes executor only if stack was empty. Executor takes whole stack at
+ * once, so everything accumulated since its last wakeup runs as one batch
+ * under single bus lock. Backlight and contrast requests don't go through
+ * the queue at all, they're posted to the pots and ride along the batch.
+ *
+ */
+class LcdExecutor
+{
+    public:
+	typedef std::function<void(I2Lcd &)> t_Operation;
+
+    private:
+	struct t_Node {
+	    t_Node *next;
+	    t_Operation op;
+	};
+
+	I2Lcd &lcd;
+	std::atomic<t_Node*> head;
+	std::atomic<bool> quit;
+	std::atomic<uint64_t> batches;
+	std::atomic<uint64_t> operations;
+	std::atomic<uint64_t> errors;
+	int wakefd;
+	std::thread worker;
+
+	void _wake(void);
+	void _execute(t_Node *list);
+	void _run(void);
+
+    public:
+	LcdExecutor(I2Lcd &display);
+	~LcdExecutor();
+
+	void submit(t_Operation op);
+	void sync(void);
+
+	void print(const string &value);
+	void printAt(uint8_t column, uint8_t row, const string &value);
+	void setCursor(uint8_t column, uint8_t row);
+	void setGC(uint8_t character, const char *bitmap);
+	void clear(void);
+	void home(void);
+	void setBacklight(uint8_t value);
+	void setContrast(uint8_t value);
+	void setLevels(uint8_t backlight, uint8_t contrast);
+
+	uint64_t getBatches(void) const { return batches; };
+	uint64_t getOperations(void) const { return operations; };
+	uint64_t getErrors(void) const { return errors; };
+};
+
+};
+
+#endif
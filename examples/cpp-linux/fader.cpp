@@ -0,0 +1,269 @@
+#include <poll.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+#include <fader.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Helper function interpolating level between two values
+ * @param from starting level
+ * @param to target level
+ * @param elapsed time since start
+ * @param duration of whole ramp
+ * @return level at given time
+ */
+static uint8_t _ramp(uint8_t from, uint8_t to, uint64_t elapsed, uint64_t duration)
+{
+    if (elapsed >= duration)
+	return to;
+    return from + ((int) to - (int) from) * (int64_t) elapsed / (int64_t) duration;
+}
+
+/**
+ * @brief Fader class constructor.
+ * Creates timer and starts background thread, which
+ * sleeps until fade is requested.
+ *
+ * @param display LCD to fade
+ * @param intervalms timer period in milliseconds
+ **/
+Fader::Fader(I2Lcd &display, unsigned intervalms) : lcd(display), interval(intervalms ? intervalms : 1),
+                                                   active(false), quit(false), start(0), duration(0)
+{
+    timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    wakefd = eventfd(0, EFD_CLOEXEC);
+    bfrom = bto = lcd.getBacklight();
+    cfrom = cto = lcd.getContrast();
+    worker = std::thread(&Fader::_run, this);
+}
+
+/**
+ * @brief Fader class destructor.
+ * Stops the background thread. Fade in progress
+ * is abandoned at its current level.
+ **/
+Fader::~Fader()
+{
+    uint64_t one = 1;
+
+    {
+	std::lock_guard<std::mutex> guard(mtx);
+	quit = true;
+    }
+    if (write(wakefd, &one, sizeof(one)) < 0) {};
+    worker.join();
+    close(timerfd);
+    close(wakefd);
+}
+
+/**
+ * @brief Start or stop periodic timer.
+ * This method is private
+ *
+ * @param on true to start timer, false to stop it
+ **/
+void Fader::_arm(bool on)
+{
+    struct itimerspec its = {};
+
+    if (on)
+    {
+	its.it_value.tv_nsec = 1;
+	its.it_interval.tv_sec = interval / 1000;
+	its.it_interval.tv_nsec = (interval % 1000) * 1000000;
+    }
+    timerfd_settime(timerfd, 0, &its, NULL);
+}
+
+/**
+ * @brief Do one step of the fade.
+ * New levels are posted first, so when text is being
+ * written, wiper pulses ride along its CPORT writes.
+ * Bus lock is only tried, never waited for and never
+ * taken while mtx is held: application threads may hold
+ * busLock() and call fade(), fadeBacklight(), fadeContrast(),
+ * stop() or busy(). When the last step finds the bus busy,
+ * fade stays active and is finished on a later timer tick.
+ * This method is private
+ *
+ * @return true if fade is finished
+ **/
+bool Fader::_tick(void)
+{
+    uint64_t elapsed, started;
+    uint8_t b, c;
+    bool last;
+
+    {
+	std::lock_guard<std::mutex> guard(mtx);
+
+	if (!active)
+	    return true;
+
+	started = start;
+	elapsed = monotonicNs() - start;
+	last = elapsed >= duration;
+	b = _ramp(bfrom, bto, elapsed, duration);
+	c = _ramp(cfrom, cto, elapsed, duration);
+
+	lcd.postLevels(b, c);
+    }
+
+    {
+	std::unique_lock<std::recursive_mutex> bus(lcd.busLock(), std::try_to_lock);
+	if (!bus.owns_lock())
+	    return false;
+
+	lcd.flushLevels();
+    }
+
+    if (last)
+    {
+	std::lock_guard<std::mutex> guard(mtx);
+
+	/* fade() may have started new fade meanwhile */
+	if (active && start == started)
+	{
+	    active = false;
+	    _arm(false);
+	    done.notify_all();
+	}
+    }
+    return last;
+}
+
+/**
+ * @brief Background thread body.
+ * Waits for timer ticks or wake up request.
+ * This method is private
+ **/
+void Fader::_run(void)
+{
+    struct pollfd fds[2];
+    uint64_t v;
+
+    fds[0].fd = timerfd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakefd;
+    fds[1].events = POLLIN;
+
+    for(;;)
+    {
+	if (poll(fds, 2, -1) < 0)
+	    continue;
+
+	if (fds[1].revents & POLLIN)
+	{
+	    if (read(wakefd, &v, sizeof(v)) < 0) {};
+	    std::lock_guard<std::mutex> guard(mtx);
+	    if (quit)
+		break;
+	}
+
+	if (fds[0].revents & POLLIN)
+	{
+	    if (read(timerfd, &v, sizeof(v)) < 0) {};
+	    _tick();
+	}
+    }
+}
+
+/**
+ * @brief Fade backlight and contrast to given levels.
+ * Levels have same meaning as for I2Lcd::setBacklight()
+ * and I2Lcd::setContrast(). Method returns immediately,
+ * fade in progress is replaced by the new one, starting
+ * from levels reached so far.
+ *
+ * @param backlight target backlight level
+ * @param contrast target contrast level
+ * @param ms duration of the fade in milliseconds
+ **/
+void Fader::fade(uint8_t backlight, uint8_t contrast, unsigned ms)
+{
+    std::lock_guard<std::mutex> guard(mtx);
+
+    bfrom = lcd.getBacklight();
+    cfrom = lcd.getContrast();
+    bto = backlight & 0x3f;
+    cto = contrast & 0x3f;
+    start = monotonicNs();
+    duration = (uint64_t) ms * 1000000;
+    active = true;
+    _arm(true);
+}
+
+/**
+ * @brief Fade only backlight. Contrast fade in progress
+ * continues to its target within new duration.
+ *
+ * @param backlight target backlight level
+ * @param ms duration of the fade in milliseconds
+ **/
+void Fader::fadeBacklight(uint8_t backlight, unsigned ms)
+{
+    uint8_t c;
+
+    {
+	std::lock_guard<std::mutex> guard(mtx);
+	c = active ? cto : lcd.getContrast();
+    }
+    fade(backlight, c, ms);
+}
+
+/**
+ * @brief Fade only contrast. Backlight fade in progress
+ * continues to its target within new duration.
+ *
+ * @param contrast target contrast level
+ * @param ms duration of the fade in milliseconds
+ **/
+void Fader::fadeContrast(uint8_t contrast, unsigned ms)
+{
+    uint8_t b;
+
+    {
+	std::lock_guard<std::mutex> guard(mtx);
+	b = active ? bto : lcd.getBacklight();
+    }
+    fade(b, contrast, ms);
+}
+
+/**
+ * @brief Stop fade in progress at level reached so far.
+ **/
+void Fader::stop(void)
+{
+    std::lock_guard<std::mutex> guard(mtx);
+
+    active = false;
+    _arm(false);
+    done.notify_all();
+}
+
+/**
+ * @brief Block until fade in progress is finished or stopped.
+ * Fade can only finish once the bus lock is free, so this must
+ * not be called while holding I2Lcd::busLock().
+ **/
+void Fader::wait(void)
+{
+    std::unique_lock<std::mutex> lock(mtx);
+
+    done.wait(lock, [this] { return !active; });
+}
+
+/**
+ * @brief Check if fade is in progress
+ *
+ * @return true if fade is in progress
+ **/
+bool Fader::busy(void)
+{
+    std::lock_guard<std::mutex> guard(mtx);
+
+    return active;
+}
@@ -0,0 +1,68 @@
+#ifndef __FADER_H__
+#define __FADER_H__
+
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+/**
+ * @class Fader
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Asynchronous backlight and contrast fade engine.
+ *
+ * Fader ramps backlight and contrast levels of an I2Lcd from current
+ * to target values over given time. Ramp is driven by timerfd in
+ * background thread, so calling thread is never blocked. On each timer
+ * tick new levels are posted to the pots and the move is finished while
+ * holding I2Lcd bus lock. If bus is busy with text, wiper pulses ride along
+ * text writes instead, so text updates never wait for a fade. The fader
+ * never waits for the bus lock, last step is retried on later ticks until
+ * the lock is free. Therefore wait() must not be called while holding
+ * I2Lcd::busLock(), other methods may be.
+ *
+ * Fader must be destroyed before the I2Lcd it drives.
+ *
+ */
+class Fader
+{
+    private:
+	I2Lcd &lcd;
+	int timerfd;
+	int wakefd;
+	unsigned interval;
+	std::thread worker;
+	std::mutex mtx;
+	std::condition_variable done;
+	bool active;
+	bool quit;
+	uint8_t bfrom, bto;
+	uint8_t cfrom, cto;
+	uint64_t start;
+	uint64_t duration;
+
+	void _arm(bool on);
+	bool _tick(void);
+	void _run(void);
+
+    public:
+	Fader(I2Lcd &display, unsigned intervalms = 10);
+	~Fader();
+
+	void fade(uint8_t backlight, uint8_t contrast, unsigned ms);
+	void fadeBacklight(uint8_t backlight, unsigned ms);
+	void fadeContrast(uint8_t contrast, unsigned ms);
+	void stop(void);
+	void wait(void);
+	bool busy(void);
+};
+
+};
+
+#endif
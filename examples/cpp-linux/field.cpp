@@ -0,0 +1,166 @@
+#include <cstring>
+#include <charconv>
+
+#include <field.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Argument spec parsed from "{:...}"
+ */
+struct t_Spec {
+    char align;
+    char fill;
+    unsigned width;
+    int precision;
+    char type;
+};
+
+/**
+ * @brief Helper parsing spec between ':' and '}'
+ */
+static void _spec(std::string_view text, t_Spec &spec)
+{
+    size_t i = 0;
+
+    spec.align = 0;
+    spec.fill = ' ';
+    spec.width = 0;
+    spec.precision = -1;
+    spec.type = 0;
+    if (i < text.size() && (text[i] == '<' || text[i] == '>' || text[i] == '^'))
+	spec.align = text[i++];
+    if (i < text.size() && text[i] == '0')
+    {
+	spec.fill = '0';
+	i++;
+    }
+    while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+	spec.width = spec.width * 10 + text[i++] - '0';
+    if (i < text.size() && text[i] == '.')
+    {
+	spec.precision = 0;
+	while (++i < text.size() && text[i] >= '0' && text[i] <= '9')
+	    spec.precision = spec.precision * 10 + text[i] - '0';
+    }
+    if (i < text.size())
+	spec.type = text[i];
+}
+
+/**
+ * @brief Helper converting argument into characters. Strings are
+ * returned in place, numbers and characters go into buffer.
+ */
+static std::string_view _convert(const t_FieldArg &arg, const t_Spec &spec, char *buf, size_t size)
+{
+    std::to_chars_result r;
+    int base = spec.type == 'x' || spec.type == 'X' ? 16 : 10;
+    char *p;
+
+    switch (arg.type)
+    {
+	case t_FieldArg::TEXT:
+	    return spec.precision >= 0 ? arg.s.substr(0, spec.precision) : arg.s;
+	case t_FieldArg::CHAR:
+	    buf[0] = arg.c;
+	    return std::string_view(buf, 1);
+	case t_FieldArg::SIGNED:
+	    r = std::to_chars(buf, buf + size, arg.i, base);
+	    break;
+	case t_FieldArg::UNSIGNED:
+	    r = std::to_chars(buf, buf + size, arg.u, base);
+	    break;
+	default:
+	    if (spec.type == 'e')
+		r = std::to_chars(buf, buf + size, arg.d, std::chars_format::scientific,
+		    spec.precision >= 0 ? spec.precision : 6);
+	    else if (spec.precision >= 0 || spec.type == 'f')
+		r = std::to_chars(buf, buf + size, arg.d, std::chars_format::fixed,
+		    spec.precision >= 0 ? spec.precision : 6);
+	    else
+		r = std::to_chars(buf, buf + size, arg.d);
+	    break;
+    }
+    if (r.ec != std::errc())
+	return std::string_view("#", 1);
+    if (spec.type == 'X')
+	for (p = buf; p < r.ptr; p++)
+	    if (*p >= 'a' && *p <= 'f')
+		*p -= 'a' - 'A';
+    return std::string_view(buf, r.ptr - buf);
+}
+
+/**
+ * @brief Format arguments into cells, see printField(). Cells beyond
+ * the formatted text are filled with spaces.
+ *
+ * @param cells first cell of the field
+ * @param width field width
+ * @param fmt format
+ * @param args arguments
+ * @param count number of arguments
+ * @return number of characters written before filling
+ */
+unsigned i2lcd::formatField(char *cells, uint8_t width, std::string_view fmt, const t_FieldArg *args,
+    unsigned count)
+{
+    char buf[64];
+    std::string_view value;
+    unsigned n = 0, next = 0, pad, lead, zeros, len;
+    size_t i, end;
+    t_Spec spec;
+    bool sign;
+
+    for (i = 0; i < fmt.size() && n < width; i++)
+    {
+	if ((fmt[i] == '{' || fmt[i] == '}') && i + 1 < fmt.size() && fmt[i + 1] == fmt[i])
+	{
+	    cells[n++] = fmt[i++];
+	    continue;
+	}
+	if (fmt[i] != '{')
+	{
+	    cells[n++] = fmt[i];
+	    continue;
+	}
+	end = fmt.find('}', i);
+	if (end == std::string_view::npos)
+	    break;
+	if (end > i + 1 && fmt[i + 1] == ':')
+	    _spec(fmt.substr(i + 2, end - i - 2), spec);
+	else
+	    _spec(std::string_view(), spec);
+	i = end;
+	if (next >= count)
+	    continue;
+
+	value = _convert(args[next], spec, buf, sizeof(buf));
+	len = value.size();
+	pad = spec.width > len ? spec.width - len : 0;
+	/* numbers go right by default, zeros go between sign and digits */
+	if (!spec.align)
+	    spec.align = args[next].type == t_FieldArg::TEXT || args[next].type == t_FieldArg::CHAR ? '<' : '>';
+	next++;
+	sign = spec.fill == '0' && !value.empty() && value[0] == '-';
+	zeros = spec.fill == '0' ? pad : 0;
+	lead = spec.fill == '0' ? 0 : spec.align == '>' ? pad : spec.align == '^' ? pad / 2 : 0;
+	for (; lead && n < width; lead--)
+	    cells[n++] = ' ';
+	if (sign && n < width)
+	{
+	    cells[n++] = '-';
+	    value.remove_prefix(1);
+	}
+	for (; zeros && n < width; zeros--)
+	    cells[n++] = '0';
+	len = value.size() < width - n ? value.size() : width - n;
+	memcpy(cells + n, value.data(), len);
+	n += len;
+	for (pad = spec.fill == '0' ? 0 : spec.align == '<' ? pad : spec.align == '^' ? pad - pad / 2 : 0;
+	    pad && n < width; pad--)
+	    cells[n++] = ' ';
+    }
+    if (n < width)
+	memset(cells + n, ' ', width - n);
+    return n;
+}
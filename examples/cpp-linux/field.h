@@ -0,0 +1,81 @@
+#ifndef __FIELD_H__
+#define __FIELD_H__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+/**
+ * @brief Argument of printField(), holds value of any supported type
+ * without copying strings
+ */
+struct t_FieldArg {
+    enum { SIGNED, UNSIGNED, REAL, TEXT, CHAR } type;
+    union {
+	long long i;
+	unsigned long long u;
+	double d;
+	char c;
+    };
+    std::string_view s;
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value
+	&& !std::is_same<T, char>::value, int>::type = 0>
+    t_FieldArg(T value) : type(SIGNED), i(value) {};
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value
+	&& !std::is_same<T, bool>::value, int>::type = 0>
+    t_FieldArg(T value) : type(UNSIGNED), u(value) {};
+    t_FieldArg(bool value) : type(TEXT), u(0), s(value ? "on" : "off") {};
+    t_FieldArg(char value) : type(CHAR), c(value) {};
+    t_FieldArg(double value) : type(REAL), d(value) {};
+    t_FieldArg(float value) : type(REAL), d(value) {};
+    t_FieldArg(const char *value) : type(TEXT), u(0), s(value) {};
+    t_FieldArg(std::string_view value) : type(TEXT), u(0), s(value) {};
+    t_FieldArg(const string &value) : type(TEXT), u(0), s(value) {};
+};
+
+unsigned formatField(char *cells, uint8_t width, std::string_view fmt, const t_FieldArg *args, unsigned count);
+
+/**
+ * @brief Format arguments into fixed width field of frame row.
+ *
+ * Format is text with "{}" for the next argument, "{{" and "}}" stand for
+ * braces. Argument may have spec after colon: alignment '<', '>' or '^',
+ * '0' to pad numbers with zeros, width, '.' and precision, and type 'd',
+ * 'x', 'X', 'f', 'e', 's' or 'c', like "{:>6.1f}" or "{:02}". Integers,
+ * floating point numbers, characters, bools and strings are accepted,
+ * other types don't compile.
+ *
+ * Text goes straight into frame cells, is cut at the field width and the
+ * rest of the field is filled with spaces, nothing is allocated. Show the
+ * frame with I2Lcd::show() to send only changed cells.
+ *
+ * @param frame
+ * @param column first column of the field
+ * @param row
+ * @param width field width, clipped at the end of the row
+ * @param fmt format
+ * @param args values
+ * @return number of characters written before filling
+ */
+template <typename... Args>
+unsigned printField(FrameBuffer &frame, uint8_t column, uint8_t row, uint8_t width, std::string_view fmt,
+    const Args &...args)
+{
+    const t_FieldArg list[sizeof...(Args) + 1] = {t_FieldArg(args)..., t_FieldArg(0)};
+
+    if (row >= frame.rows() || column >= frame.columns())
+	return 0;
+    if (width > frame.columns() - column)
+	width = frame.columns() - column;
+    return formatField(frame.row(row) + column, width, fmt, list, sizeof...(Args));
+}
+
+};
+
+#endif
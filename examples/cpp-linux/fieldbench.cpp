@@ -0,0 +1,107 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <iomanip>
+
+#include <framebuffer.h>
+#include <field.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Telemetry fields of 20x4 frame formatted over and over: voltage,
+ * current, temperature and counter in fixed width fields. printField()
+ * is compared with std::ostringstream and with snprintf() into string,
+ * CPU time and heap allocations per field.
+ *
+ * usage: fieldbench [frames]
+ */
+
+static unsigned long allocations;
+
+void *operator new(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+
+    allocations++;
+    if (!p)
+	throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+static void _field(FrameBuffer &frame, unsigned i)
+{
+    printField(frame, 0, 0, 10, "U {:6.2f}V", 11.5 + (i % 100) * 0.013);
+    printField(frame, 10, 0, 10, "I {:5.3f}A", (i % 1000) * 0.001);
+    printField(frame, 0, 1, 10, "T {:5.1f}C", 20 + (i % 300) * 0.1);
+    printField(frame, 10, 1, 10, "n {:>7}", i);
+}
+
+static void _stream(FrameBuffer &frame, unsigned i)
+{
+    std::ostringstream u, c, t, n;
+
+    u << "U " << std::fixed << std::setprecision(2) << std::setw(6) << 11.5 + (i % 100) * 0.013 << "V";
+    c << "I " << std::fixed << std::setprecision(3) << std::setw(5) << (i % 1000) * 0.001 << "A";
+    t << "T " << std::fixed << std::setprecision(1) << std::setw(5) << 20 + (i % 300) * 0.1 << "C";
+    n << "n " << std::setw(7) << i;
+    frame.print(0, 0, u.str());
+    frame.print(10, 0, c.str());
+    frame.print(0, 1, t.str());
+    frame.print(10, 1, n.str());
+}
+
+static void _printf(FrameBuffer &frame, unsigned i)
+{
+    char buf[100];
+
+    snprintf(buf, sizeof(buf), "U %6.2fV", 11.5 + (i % 100) * 0.013);
+    frame.print(0, 0, std::string(buf).substr(0, 10));
+    snprintf(buf, sizeof(buf), "I %5.3fA", (i % 1000) * 0.001);
+    frame.print(10, 0, std::string(buf).substr(0, 10));
+    snprintf(buf, sizeof(buf), "T %5.1fC", 20 + (i % 300) * 0.1);
+    frame.print(0, 1, std::string(buf).substr(0, 10));
+    snprintf(buf, sizeof(buf), "n %7u", i);
+    frame.print(10, 1, std::string(buf).substr(0, 10));
+}
+
+int main(int argc, char **argv)
+{
+    unsigned frames = argc > 1 ? atoi(argv[1]) : 200000;
+    const char *names[] = {"printField", "snprintf", "ostream"};
+    FrameBuffer frame(20, 4);
+    unsigned long before;
+    unsigned i, mode;
+    double t;
+
+    printf("path        ns/field  allocations/field\n");
+    for (mode = 0; mode < 3; mode++)
+    {
+	before = allocations;
+	steady_clock::time_point start = steady_clock::now();
+	for (i = 0; i < frames; i++)
+	    if (mode == 0)
+		_field(frame, i);
+	    else if (mode == 1)
+		_printf(frame, i);
+	    else
+		_stream(frame, i);
+	t = duration<double, std::nano>(steady_clock::now() - start).count();
+	printf("%-10s %9.1f %18.2f\n", names[mode], t / frames / 4, (double) (allocations - before) / frames / 4);
+    }
+    printf("\n|%s|\n|%s|\n", frame.text(0).c_str(), frame.text(1).c_str());
+}
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <fixedlcd.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * DDRAM address of every cell of 20x4 display resolved by LcdType
+ * decoded at run time, with range checks, and by LcdGeometry constants.
+ * Then every row is printed with setCursor() and print() and with
+ * FixedLcd::print<column, row>() on simulated bus, both must leave the
+ * same content and bus bytes.
+ *
+ * usage: fixedbench [passes]
+ */
+
+static_assert(LcdGeometry<D20x4>::cells == 80, "20x4 has 80 cells");
+static_assert(LcdGeometry<D20x4>::address<0, 2>() == 0x14, "third row of 20x4 follows first");
+static_assert(LcdGeometry<D16x0>::rows == 1 && LcdGeometry<D40x2>::columns == 40, "geometry decoded");
+
+int main(int argc, char **argv)
+{
+    unsigned passes = argc > 1 ? atoi(argv[1]) : 1000000;
+    volatile t_LCDType runtime = D20x4;
+    typedef LcdGeometry<D20x4> G;
+    const char *rows[4] = {"Fixed geometry", "rows and columns", "are constants", "at compile time"};
+    unsigned long bytes[2], sum = 0;
+    unsigned p, c, r;
+    double t;
+
+    steady_clock::time_point start = steady_clock::now();
+    for (p = 0; p < passes; p++)
+    {
+	LcdType type(runtime);
+
+	for (r = 0; r < type.getRows(); r++)
+	    for (c = 0; c < type.getColumns(); c++)
+		sum += type.ddAddress(c, r);
+    }
+    t = duration<double, std::nano>(steady_clock::now() - start).count() / passes / G::cells;
+    printf("LcdType       %6.2f ns per address\n", t);
+
+    start = steady_clock::now();
+    for (p = 0; p < passes; p++)
+	for (r = 0; r < G::rows; r++)
+	    for (c = 0; c < G::columns; c++)
+		sum += G::address(c, r) + (p & 1);
+    t = duration<double, std::nano>(steady_clock::now() - start).count() / passes / G::cells;
+    printf("LcdGeometry   %6.2f ns per address\n", t);
+
+    SimBus bus;
+    {
+	I2Lcd lcd(bus, 0x20, D20x4);
+
+	lcd.power(POWERON);
+	bus.resetCounters();
+	for (r = 0; r < 4; r++)
+	{
+	    lcd.setCursor(0, r);
+	    lcd.print(rows[r]);
+	}
+	bytes[0] = bus.getBytes();
+    }
+    {
+	Lcd20x4 lcd(bus, 0x20);
+
+	lcd.power(POWERON);
+	bus.resetCounters();
+	lcd.print<0, 0>(rows[0]);
+	lcd.print<0, 1>(rows[1]);
+	lcd.print<0, 2>(rows[2]);
+	lcd.print<0, 3>(rows[3]);
+	bytes[1] = bus.getBytes();
+	for (r = 0; r < 4; r++)
+	    if (bus.visible(0x20, lcd.type(), r).compare(0, strlen(rows[r]), rows[r]))
+		printf("row %u differs: %s\n", r, bus.visible(0x20, lcd.type(), r).c_str());
+    }
+    printf("bus bytes: setCursor()+print() %lu, print<c, r>() %lu\n", bytes[0], bytes[1]);
+    return sum == 0;
+}
@@ -0,0 +1,105 @@
+#ifndef __FIXEDLCD_H__
+#define __FIXEDLCD_H__
+
+#include <cstdint>
+#include <string_view>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+/**
+ * @brief Geometry of LCD type decoded at compile time. Sizes and
+ * row addresses are constants, addresses of positions given as
+ * template arguments are checked by static_assert.
+ */
+template <t_LCDType T>
+struct LcdGeometry {
+    static constexpr LcdType type{T};
+    static constexpr t_LCDType id = T;
+    static constexpr uint8_t columns = type.getColumns();
+    static constexpr uint8_t rows = type.getRows();
+    static constexpr unsigned cells = columns * rows;
+    static constexpr uint8_t rowaddr[4] = {
+	type[0], rows > 1 ? type[1] : (uint8_t) 0, rows > 2 ? type[2] : (uint8_t) 0, rows > 3 ? type[3] : (uint8_t) 0
+    };
+
+    /**
+     * @brief DDRAM address of position, caller keeps it in range
+     **/
+    static constexpr uint8_t address(uint8_t column, uint8_t row) noexcept { return rowaddr[row & 3] + column; };
+
+    /**
+     * @brief DDRAM address of constant position, checked at compile time
+     **/
+    template <uint8_t C, uint8_t R>
+    static constexpr uint8_t address(void) noexcept
+    {
+	static_assert(R < rows, "Row number out of range");
+	static_assert(C < columns, "Column number out of range");
+	return rowaddr[R] + C;
+    };
+
+    static constexpr bool contains(uint8_t column, uint8_t row) noexcept { return column < columns && row < rows; };
+};
+
+/**
+ * @class FixedLcd
+ *
+ * @ingroup i2lcd
+ *
+ * @brief I2Lcd with display type fixed at compile time.
+ *
+ * Geometry (LcdGeometry) gives rows, columns and DDRAM addresses as
+ * constants, so print<column, row>() compiles down to a constant address
+ * command followed by the characters, out of range position doesn't
+ * compile. put() takes position at run time, checks it against constant
+ * sizes and returns false instead of throwing. Everything else is I2Lcd.
+ *
+ */
+template <class Geometry>
+class FixedLcd : public I2Lcd
+{
+    public:
+	typedef Geometry geometry;
+
+	FixedLcd(uint8_t bus, uint8_t address, const char *statedir = NULL) : I2Lcd(bus, address, Geometry::id, statedir) {};
+	FixedLcd(I2CBus &bus, uint8_t address, const char *statedir = NULL) : I2Lcd(bus, address, Geometry::id, statedir) {};
+
+	static constexpr uint8_t rows(void) { return Geometry::rows; };
+	static constexpr uint8_t columns(void) { return Geometry::columns; };
+
+	using I2Lcd::print;
+
+	/**
+	 * @brief Print text at constant position, cut at the end of the row
+	 **/
+	template <uint8_t C, uint8_t R>
+	void print(std::string_view text)
+	{
+	    constexpr uint8_t address = Geometry::template address<C, R>();
+
+	    _put(address, C, R, text.data(), text.size() < (unsigned) (Geometry::columns - C) ? text.size() : Geometry::columns - C);
+	};
+
+	/**
+	 * @brief Print text at position, cut at the end of the row
+	 *
+	 * @return false when position is outside of the display
+	 **/
+	bool put(uint8_t column, uint8_t row, std::string_view text)
+	{
+	    if (!Geometry::contains(column, row))
+		return false;
+	    _put(Geometry::address(column, row), column, row, text.data(),
+		text.size() < (unsigned) (Geometry::columns - column) ? text.size() : Geometry::columns - column);
+	    return true;
+	};
+};
+
+typedef FixedLcd<LcdGeometry<D16x2> > Lcd16x2;
+typedef FixedLcd<LcdGeometry<D20x4> > Lcd20x4;
+
+};
+
+#endif
@@ -0,0 +1,199 @@
+#include <cstring>
+
+#include <framebuffer.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Helper function appending command to operations list
+ */
+static void _command(std::vector<t_LcdOp> &ops, t_Command command, uint8_t value)
+{
+    t_LcdOp op = {false, (uint8_t) (value | (1 << (uint8_t) command))};
+
+    ops.push_back(op);
+}
+
+/**
+ * @brief Helper function appending data byte to operations list
+ */
+static void _data(std::vector<t_LcdOp> &ops, char value)
+{
+    t_LcdOp op = {true, (uint8_t) value};
+
+    ops.push_back(op);
+}
+
+/**
+ * @brief FrameBuffer class constructor.
+ * Frame is filled with spaces and empty glyphs.
+ *
+ * @param columns number of columns (up to 40)
+ * @param rows number of rows (up to 4)
+ **/
+FrameBuffer::FrameBuffer(uint8_t columns, uint8_t rows) : cols(columns > FB_MAX_COLUMNS ? FB_MAX_COLUMNS : columns),
+                                                          nrows(rows > FB_MAX_ROWS ? FB_MAX_ROWS : (rows ? rows : 1))
+{
+    clear();
+    memset(glyphs, 0, sizeof(glyphs));
+}
+
+/**
+ * @brief Fill all cells with given character
+ *
+ * @param fill character
+ **/
+void FrameBuffer::clear(char fill)
+{
+    memset(cells, fill, sizeof(cells));
+}
+
+/**
+ * @brief Put single character. Cells outside of
+ * the frame are ignored.
+ *
+ * @param column
+ * @param row
+ * @param c character
+ **/
+void FrameBuffer::put(uint8_t column, uint8_t row, char c)
+{
+    if (column < cols && row < nrows)
+	cells[row][column] = c;
+}
+
+/**
+ * @brief Put characters into single row, clipped at
+ * the right edge of the frame.
+ *
+ * @param column
+ * @param row
+ * @param text characters
+ * @param len number of characters
+ **/
+void FrameBuffer::put(uint8_t column, uint8_t row, const char *text, unsigned len)
+{
+    if (column >= cols || row >= nrows)
+	return;
+    if (len > (unsigned) (cols - column))
+	len = cols - column;
+    memcpy(&cells[row][column], text, len);
+}
+
+/**
+ * @brief Print string the way I2Lcd::print() does:
+ * text continues in next row when it doesn't fit,
+ * '\\n' starts next row, last row wraps to the first one.
+ *
+ * @param column
+ * @param row
+ * @param text
+ **/
+void FrameBuffer::print(uint8_t column, uint8_t row, const string &text)
+{
+    size_t i;
+
+    for (i = 0; i < text.size(); i++)
+    {
+	if (text[i] == '\n')
+	{
+	    row = (row + 1) % nrows;
+	    column = 0;
+	    continue;
+	}
+	put(column, row, text[i]);
+	if (++column >= cols)
+	{
+	    row = (row + 1) % nrows;
+	    column = 0;
+	}
+    }
+}
+
+/**
+ * @brief Set bitmap of graphical character
+ *
+ * @param character number (0-7)
+ * @param bitmap 8 bytes
+ **/
+void FrameBuffer::setGC(uint8_t character, const char *bitmap)
+{
+    memcpy(glyphs[character & 0x07], bitmap, 8);
+}
+
+/**
+ * @brief Append operations changing display showing this
+ * frame into one showing target frame, and make this frame
+ * equal to target. Changed glyph rows are sent first, then
+ * changed runs of cells. Runs separated by single unchanged
+ * cell are joined, as rewriting it costs the same as
+ * setting new address.
+ *
+ * @param target frame to show
+ * @param type of the LCD, for row addresses
+ * @param ops operations list to append to
+ * @param full if true, every cell and glyph is sent
+ **/
+void FrameBuffer::update(const FrameBuffer &target, const LcdType &type, std::vector<t_LcdOp> &ops, bool full)
+{
+    uint8_t g, b, r, c, start, end, lastcg = 0xff;
+    uint8_t rows = nrows < target.nrows ? nrows : target.nrows;
+    uint8_t columns = cols < target.cols ? cols : target.cols;
+
+    for (g = 0; g < 8; g++)
+	for (b = 0; b < 8; b++)
+	{
+	    if (!full && glyphs[g][b] == target.glyphs[g][b])
+		continue;
+	    if (lastcg != g * 8 + b)
+		_command(ops, SET_CGRAM_ADDRESS, type.cgAddress(g, b));
+	    _data(ops, target.glyphs[g][b]);
+	    glyphs[g][b] = target.glyphs[g][b];
+	    lastcg = g * 8 + b + 1;
+	}
+
+    for (r = 0; r < rows; r++)
+    {
+	c = 0;
+	while (c < columns)
+	{
+	    if (!full && cells[r][c] == target.cells[r][c])
+	    {
+		c++;
+		continue;
+	    }
+	    start = end = c;
+	    for (c++; c < columns; c++)
+	    {
+		if (full || cells[r][c] != target.cells[r][c])
+		    end = c;
+		else if (c - end > 1)
+		    break;
+	    }
+	    _command(ops, SET_DDRAM_ADDRESS, type.ddAddress(start, r));
+	    for (c = start; c <= end; c++)
+	    {
+		_data(ops, target.cells[r][c]);
+		cells[r][c] = target.cells[r][c];
+	    }
+	}
+    }
+}
+
+/**
+ * @brief Compare frames
+ *
+ * @param other frame
+ * @return true if cells and glyphs are equal
+ **/
+bool FrameBuffer::operator==(const FrameBuffer &other) const
+{
+    uint8_t r;
+
+    if (cols != other.cols || nrows != other.nrows || memcmp(glyphs, other.glyphs, sizeof(glyphs)))
+	return false;
+    for (r = 0; r < nrows; r++)
+	if (memcmp(cells[r], other.cells[r], cols))
+	    return false;
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef __FRAMEBUFFER_H__
+#define __FRAMEBUFFER_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+#define FB_MAX_COLUMNS	40
+#define FB_MAX_ROWS	4
+
+/**
+ * @class FrameBuffer
+ *
+ * @ingroup i2lcd
+ *
+ * @brief In-memory copy of display content.
+ *
+ * Holds DDRAM cells of all visible rows and eight CGRAM glyphs.
+ * Frames are composed in memory and sent to display with I2Lcd::show()
+ * or BusScheduler::show(), which only transfer cells that differ from
+ * what the display already shows.
+ *
+ */
+class FrameBuffer
+{
+    private:
+	uint8_t cols;
+	uint8_t nrows;
+	char cells[FB_MAX_ROWS][FB_MAX_COLUMNS];
+	char glyphs[8][8];
+
+    public:
+	FrameBuffer(uint8_t columns = 16, uint8_t rows = 2);
+
+	uint8_t columns(void) const { return cols; };
+	uint8_t rows(void) const { return nrows; };
+
+	void clear(char fill = ' ');
+	void put(uint8_t column, uint8_t row, char c);
+	void put(uint8_t column, uint8_t row, const char *text, unsigned len);
+	void print(uint8_t column, uint8_t row, const string &text);
+	void setGC(uint8_t character, const char *bitmap);
+
+	char at(uint8_t column, uint8_t row) const { return cells[row][column]; };
+	char *row(uint8_t row) { return cells[row]; };
+	const char *row(uint8_t row) const { return cells[row]; };
+	const char *glyph(uint8_t character) const { return glyphs[character & 0x07]; };
+	string text(uint8_t row) const { return string(cells[row], cols); };
+
+	void update(const FrameBuffer &target, const LcdType &type, std::vector<t_LcdOp> &ops, bool full = false);
+	bool operator==(const FrameBuffer &other) const;
+};
+
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include <cstring>
+
+#include <glyphband.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief GlyphBand class constructor
+ *
+ * @param display
+ * @param column left column of the band, band off the display has no cells
+ * @param row
+ * @param cells width of the band in cells, 1-8
+ * @param slot first CGRAM slot, band uses slots up to slot + cells - 1
+ **/
+GlyphBand::GlyphBand(I2Lcd &display, uint8_t column, uint8_t row, uint8_t cells, uint8_t slot) : lcd(display),
+    column(column), row(row), valid(false), bytes(0)
+{
+    this->slot = slot & 0x07;
+    ncells = cells < 8 - this->slot ? cells : 8 - this->slot;
+    if (column >= lcd.columns() || row >= lcd.rows())
+	ncells = 0;
+    else if (ncells > lcd.columns() - column)
+	ncells = lcd.columns() - column;
+}
+
+/**
+ * @brief Send changed CGRAM bytes of the band. First call and call
+ * after redraw() load all bytes and put the band into DDRAM.
+ *
+ * @param next 8 bytes per cell, rows of the first cell first
+ * @param budget most bytes to send, ignored when loading all
+ * @return number of CGRAM bytes sent
+ **/
+unsigned GlyphBand::send(const char *next, unsigned budget)
+{
+    char band[BAND_MAX_CELLS];
+    uint8_t n = ncells * 8;
+    uint8_t i, first, last;
+    unsigned sent = 0;
+
+    if (!ncells)
+	return 0;
+    if (!valid)
+    {
+	lcd.setGCRows(slot, 0, next, n);
+	for (i = 0; i < ncells; i++)
+	    band[i] = slot + i;
+	lcd.setCursor(column, row);
+	lcd.print(string(band, ncells));
+	memcpy(cgram, next, n);
+	bytes += n;
+	valid = true;
+	return n;
+    }
+
+    for (i = 0; i < n && sent < budget; i++)
+    {
+	if (next[i] == cgram[i])
+	    continue;
+	/* single unchanged byte costs less than new SET_CGRAM_ADDRESS */
+	first = last = i;
+	while (++i < n && (unsigned) (i - first) < budget - sent)
+	    if (next[i] != cgram[i])
+		last = i;
+	    else if (i + 1 >= n || next[i + 1] == cgram[i + 1])
+		break;
+	lcd.setGCRows(slot + first / 8, first % 8, next + first, last - first + 1);
+	memcpy(cgram + first, next + first, last - first + 1);
+	sent += last - first + 1;
+    }
+    bytes += sent;
+    return sent;
+}
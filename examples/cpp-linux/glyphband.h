@@ -0,0 +1,53 @@
+#ifndef __GLYPHBAND_H__
+#define __GLYPHBAND_H__
+
+#include <cstdint>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+#define BAND_MAX_CELLS	8
+#define BAND_UNLIMITED	(~0u)
+
+/**
+ * @class GlyphBand
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Row of cells showing user characters, each cell its own CGRAM
+ * slot, for widgets which draw by rewriting CGRAM bytes.
+ *
+ * Band is clipped to the display and to CGRAM slots, band starting off
+ * the display has no cells and draws nothing. It is written to DDRAM only
+ * once, then send() compares new bitmaps with copy of loaded CGRAM and
+ * sends only changed runs of bytes with setGCRows(), optionally at most
+ * budget bytes per call. Bytes left out stay different from the copy and
+ * go out with the next call.
+ *
+ */
+class GlyphBand
+{
+    private:
+	I2Lcd &lcd;
+	uint8_t column;
+	uint8_t row;
+	uint8_t ncells;
+	uint8_t slot;
+	char cgram[BAND_MAX_CELLS * 8];
+	bool valid;
+	unsigned long bytes;
+
+    public:
+	GlyphBand(I2Lcd &display, uint8_t column, uint8_t row, uint8_t cells, uint8_t slot);
+
+	unsigned send(const char *next, unsigned budget = BAND_UNLIMITED);
+	void redraw(void) { valid = false; };
+
+	uint8_t cells(void) const { return ncells; };
+	unsigned long getBytes(void) const { return bytes; };
+};
+
+};
+
+#endif
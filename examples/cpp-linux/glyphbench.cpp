@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <unistd.h>
+
+#include <framebuffer.h>
+#include <glyphpack.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Icon library of 4096 glyphs as memory mapped glyph pack and as C header
+ * text in hex like editlcd saves it. Time to open the library and load
+ * eight icons into a frame is compared: mapping checks only the header,
+ * header text has to be parsed whole.
+ *
+ * usage: glyphbench [glyphs]
+ */
+
+int main(int argc, char **argv)
+{
+    unsigned count = argc > 1 ? atoi(argv[1]) : 4096;
+    const char *packpath = "/tmp/glyphbench.glp", *textpath = "/tmp/glyphbench.h";
+    std::vector<std::string> names, bitmaps;
+    std::vector<const char *> n, b;
+    FrameBuffer frame(20, 4);
+    unsigned i, r, runs = 20;
+    char name[32];
+    double t;
+    FILE *f;
+
+    f = fopen(textpath, "w");
+    for (i = 0; i < count; i++)
+    {
+	snprintf(name, sizeof(name), "icon%u", i);
+	names.push_back(name);
+	bitmaps.push_back(std::string(8, '\0'));
+	for (r = 0; r < 8; r++)
+	    bitmaps[i][r] = (i * 7 + r * 13) & 0x1f;
+	fprintf(f, "char %s[8] = {", name);
+	for (r = 0; r < 8; r++)
+	    fprintf(f, " 0x%02X,", bitmaps[i][r]);
+	fprintf(f, " };\n");
+    }
+    fclose(f);
+    for (i = 0; i < count; i++)
+    {
+	n.push_back(names[i].c_str());
+	b.push_back(bitmaps[i].data());
+    }
+    GlyphPack::write(packpath, n.data(), b.data(), count);
+
+    steady_clock::time_point start = steady_clock::now();
+    for (unsigned k = 0; k < runs; k++)
+    {
+	GlyphPack pack(packpath);
+
+	for (i = 0; i < 8; i++)
+	{
+	    snprintf(name, sizeof(name), "icon%u", (i * 509 + k) % count);
+	    frame.setGC(i, pack.bitmap(name));
+	}
+    }
+    t = duration<double, std::micro>(steady_clock::now() - start).count() / runs;
+    printf("glyph pack  %8.1f us to open and load 8 of %u glyphs\n", t, count);
+
+    start = steady_clock::now();
+    for (unsigned k = 0; k < runs; k++)
+    {
+	std::vector<std::string> found;
+	std::vector<std::string> bits;
+	char line[256], *p;
+
+	f = fopen(textpath, "r");
+	while (fgets(line, sizeof(line), f))
+	{
+	    if (sscanf(line, "char %31[^[]", name) != 1 || !(p = strchr(line, '{')))
+		continue;
+	    std::string g;
+	    for (r = 0; r < 8; r++)
+		g += (char) strtol(p + 1, &p, 16), p++;
+	    found.push_back(name);
+	    bits.push_back(g);
+	}
+	fclose(f);
+	for (i = 0; i < 8; i++)
+	{
+	    snprintf(name, sizeof(name), "icon%u", (i * 509 + k) % count);
+	    for (r = 0; r < found.size() && found[r] != name; r++)
+		;
+	    frame.setGC(i, bits[r].data());
+	}
+    }
+    t = duration<double, std::micro>(steady_clock::now() - start).count() / runs;
+    printf("header text %8.1f us to parse and load 8 of %u glyphs\n", t, count);
+
+    unlink(packpath);
+    unlink(textpath);
+}
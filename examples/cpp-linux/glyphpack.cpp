@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <glyphpack.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief GlyphPack class constructor, maps the file
+ *
+ * @param path glyph pack file
+ **/
+GlyphPack::GlyphPack(const char *path) : map(NULL), length(0)
+{
+    struct stat st;
+    void *p;
+    int fd;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+	throw tGlyphPackOpen;
+    if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(t_PackHeader))
+    {
+	close(fd);
+	throw tGlyphPackOpen;
+    }
+    length = st.st_size;
+    p = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+	throw tGlyphPackOpen;
+    map = (const uint8_t *) p;
+
+    header = (const t_PackHeader *) map;
+    glyphs = (const t_PackGlyph *) (map + sizeof(t_PackHeader));
+    index = (const uint16_t *) (map + header->index);
+    if (header->magic != GLYPHPACK_MAGIC || header->version != GLYPHPACK_VERSION || header->size != length
+	|| header->index != sizeof(t_PackHeader) + header->count * sizeof(t_PackGlyph)
+	|| header->index + header->count * sizeof(uint16_t) > length)
+    {
+	munmap((void *) map, length);
+	throw tGlyphPackOpen;
+    }
+}
+
+/**
+ * @brief GlyphPack class destructor, bitmaps are no longer valid
+ **/
+GlyphPack::~GlyphPack()
+{
+    munmap((void *) map, length);
+}
+
+/**
+ * @brief Name of glyph
+ *
+ * @param n record number
+ **/
+string GlyphPack::name(unsigned n) const
+{
+    return string(glyphs[n].name, strnlen(glyphs[n].name, GLYPHPACK_NAME));
+}
+
+/**
+ * @brief Helper comparing record name with name. This method is private
+ **/
+int GlyphPack::_compare(uint16_t record, const char *name) const
+{
+    return record < header->count ? strncmp(glyphs[record].name, name, GLYPHPACK_NAME) : 1;
+}
+
+/**
+ * @brief Find glyph by name
+ *
+ * @param name
+ * @return record number, -1 when there's no such glyph
+ **/
+int GlyphPack::find(const char *name) const
+{
+    unsigned lo = 0, hi = header->count, mid;
+    int c;
+
+    while (lo < hi)
+    {
+	mid = (lo + hi) / 2;
+	c = _compare(index[mid], name);
+	if (!c)
+	    return index[mid];
+	if (c < 0)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    return -1;
+}
+
+/**
+ * @brief Bitmap of glyph found by name
+ *
+ * @param name
+ * @return 8 bytes in the mapping, NULL when there's no such glyph
+ **/
+const char *GlyphPack::bitmap(const char *name) const
+{
+    int n = find(name);
+
+    return n < 0 ? NULL : glyphs[n].bitmap;
+}
+
+/**
+ * @brief Load glyph into user character of display
+ *
+ * @param lcd
+ * @param character number 0-7
+ * @param name
+ * @return false when there's no such glyph
+ **/
+bool GlyphPack::load(I2Lcd &lcd, uint8_t character, const char *name) const
+{
+    const char *b = bitmap(name);
+
+    if (b)
+	lcd.setGC(character, b);
+    return b != NULL;
+}
+
+/**
+ * @brief Write glyph pack. File is written under temporary name and
+ * renamed, so processes which have the old pack mapped keep it.
+ *
+ * @param path
+ * @param names glyph names, longer names are cut
+ * @param bitmaps 8 bytes each
+ * @param count number of glyphs, up to 65535
+ * @return false on error
+ **/
+bool GlyphPack::write(const char *path, const char *const *names, const char *const *bitmaps, unsigned count)
+{
+    std::vector<t_PackGlyph> records(count);
+    std::vector<uint16_t> order(count);
+    string temp = string(path) + ".tmp";
+    t_PackHeader header;
+    unsigned i;
+    FILE *f;
+    bool ok;
+
+    if (count > 0xffff)
+	return false;
+    for (i = 0; i < count; i++)
+    {
+	memset(&records[i], 0, sizeof(t_PackGlyph));
+	strncpy(records[i].name, names[i], GLYPHPACK_NAME);
+	memcpy(records[i].bitmap, bitmaps[i], 8);
+	order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&records](uint16_t a, uint16_t b) {
+	return strncmp(records[a].name, records[b].name, GLYPHPACK_NAME) < 0;
+    });
+
+    header.magic = GLYPHPACK_MAGIC;
+    header.version = GLYPHPACK_VERSION;
+    header.count = count;
+    header.index = sizeof(t_PackHeader) + count * sizeof(t_PackGlyph);
+    header.size = header.index + count * sizeof(uint16_t);
+
+    f = fopen(temp.c_str(), "wb");
+    if (!f)
+	return false;
+    ok = fwrite(&header, sizeof(header), 1, f) == 1
+	&& fwrite(records.data(), sizeof(t_PackGlyph), count, f) == count
+	&& fwrite(order.data(), sizeof(uint16_t), count, f) == count;
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(temp.c_str(), path) < 0)
+    {
+	unlink(temp.c_str());
+	return false;
+    }
+    return true;
+}
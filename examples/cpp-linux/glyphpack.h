@@ -0,0 +1,93 @@
+#ifndef __GLYPHPACK_H__
+#define __GLYPHPACK_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+#define GLYPHPACK_MAGIC		0x4b504c47
+#define GLYPHPACK_VERSION	1
+#define GLYPHPACK_NAME		24
+
+/**
+ * @brief Glyph pack file header. Glyph records follow the header,
+ * index of record numbers sorted by name follows the records.
+ * Numbers are little endian.
+ */
+struct t_PackHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t index;
+    uint32_t size;
+};
+
+/**
+ * @brief Glyph record, name is zero padded and may fill whole field
+ */
+struct t_PackGlyph {
+    char name[GLYPHPACK_NAME];
+    char bitmap[8];
+};
+
+/**
+ * @class GlyphPackOpen
+ *
+ * @ingroup i2lcd
+ *
+ * @brief GlyphPackOpen Exception class thrown when glyph pack can't be
+ *        opened or mapped, or isn't glyph pack of known version
+ *
+ *
+ */
+class GlyphPackOpen: public exception
+{
+} tGlyphPackOpen;
+
+/**
+ * @class GlyphPack
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Named user character bitmaps in memory mapped file.
+ *
+ * Pack is mapped read only and only its header is checked, records are
+ * used where they lie: bitmap() points into the mapping and goes to
+ * I2Lcd::setGC() or FrameBuffer::setGC() as it is. find() searches sorted
+ * index by name. Pack files are replaced by rename, so pack can be
+ * swapped at runtime by opening new GlyphPack while old mapping stays
+ * valid until its object is destroyed.
+ *
+ */
+class GlyphPack
+{
+    private:
+	const uint8_t *map;
+	size_t length;
+	const t_PackHeader *header;
+	const t_PackGlyph *glyphs;
+	const uint16_t *index;
+
+	int _compare(uint16_t record, const char *name) const;
+
+    public:
+	GlyphPack(const char *path);
+	~GlyphPack();
+
+	unsigned count(void) const { return header->count; };
+	string name(unsigned n) const;
+	const char *bitmap(unsigned n) const { return glyphs[n].bitmap; };
+	int find(const char *name) const;
+	const char *bitmap(const char *name) const;
+	bool load(I2Lcd &lcd, uint8_t character, const char *name) const;
+
+	static bool write(const char *path, const char *const *names, const char *const *bitmaps, unsigned count);
+};
+
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+
+#include <unistd.h>
+
+#include <string>
+
+#include <pca9535.h>
+#include <i2cbus.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Write single register of a chip
+ * @param address chip address
+ * @param reg register number
+ * @param value to set
+ **/
+void I2CBus::writeRegister(uint8_t address, uint8_t reg, uint8_t value)
+{
+    uint8_t buf[2] = {reg, value};
+    struct i2c_msg msg = {address, 0, 2, buf};
+
+    transfer(&msg, 1);
+}
+
+/**
+ * @brief Write register and the next one in one transaction.
+ *        Chips like PCA9535 move to the other register of
+ *        the pair after each data byte.
+ * @param address chip address
+ * @param reg first register number
+ * @param first value of first register
+ * @param second value of second register
+ **/
+void I2CBus::writeRegisters(uint8_t address, uint8_t reg, uint8_t first, uint8_t second)
+{
+    uint8_t buf[3] = {reg, first, second};
+    struct i2c_msg msg = {address, 0, 3, buf};
+
+    transfer(&msg, 1);
+}
+
+/**
+ * @brief Read single register of a chip
+ * @param address chip address
+ * @param reg register number
+ * @return register value
+ **/
+uint8_t I2CBus::readRegister(uint8_t address, uint8_t reg)
+{
+    uint8_t value = 0;
+    struct i2c_msg msgs[2] = {{address, 0, 1, &reg}, {address, I2C_M_RD, 1, &value}};
+
+    transfer(msgs, 2);
+    return value;
+}
+
+/**
+ * @brief Class constructor. Opens /dev/i2c-N device
+ *        and checks if adapter can do plain I2C transfers.
+ * @param busn bus number
+ **/
+I2CDevBus::I2CDevBus(uint8_t busn) : I2CBus(busn)
+{
+    string s = "/dev/i2c-" + to_string(busn);
+
+    unsigned long funcs = 0;
+
+    fileh = open(s.c_str(), O_RDWR);
+    if (fileh == -1)
+	throw tPEXOpen;
+
+    if (ioctl(fileh, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C))
+    {
+	close(fileh);
+	throw tPEXIOctl;
+    }
+}
+
+/**
+ * @brief Class destructor
+ **/
+I2CDevBus::~I2CDevBus()
+{
+    if (fileh != -1)
+	close(fileh);
+}
+
+/**
+ * @brief Send messages with I2C_RDWR ioctl. Kernel accepts
+ *        at most 42 messages per call, longer lists are split.
+ * @param msgs array of messages
+ * @param count number of messages
+ * @return number of messages transferred or -1 on error
+ **/
+int I2CDevBus::transfer(struct i2c_msg *msgs, unsigned count)
+{
+    struct i2c_rdwr_ioctl_data data;
+    unsigned done = 0;
+
+    while (done < count)
+    {
+	data.msgs = msgs + done;
+	data.nmsgs = count - done < I2C_RDWR_MAX_MSGS ? count - done : I2C_RDWR_MAX_MSGS;
+	if (ioctl(fileh, I2C_RDWR, &data) < 0)
+	    return -1;
+	done += data.nmsgs;
+    }
+    return done;
+}
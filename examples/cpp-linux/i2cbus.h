@@ -0,0 +1,65 @@
+#ifndef __I2CBUS_H__
+#define __I2CBUS_H__
+
+#include <cstdint>
+#include <linux/i2c.h>
+
+#define I2C_RDWR_MAX_MSGS 42
+
+namespace i2lcd {
+
+/**
+ * @class I2CBus
+ *
+ * @ingroup i2lcd
+ *
+ * @brief I2C bus transport interface
+ *
+ * Base class for everything PCA9535 can talk through. Transfer sends
+ * list of I2C messages in one go, every message carries its own slave
+ * address, so many chips can share one bus object.
+ *
+ */
+class I2CBus
+{
+    protected:
+	uint8_t number;
+
+    public:
+	I2CBus(uint8_t busn) : number(busn) {};
+	virtual ~I2CBus() {};
+
+	virtual int transfer(struct i2c_msg *msgs, unsigned count) = 0;
+
+	uint8_t getNumber() const { return number; };
+	void writeRegister(uint8_t address, uint8_t reg, uint8_t value);
+	void writeRegisters(uint8_t address, uint8_t reg, uint8_t first, uint8_t second);
+	uint8_t readRegister(uint8_t address, uint8_t reg);
+};
+
+/**
+ * @class I2CDevBus
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Linux i2c-dev transport
+ *
+ * Owns /dev/i2c-N file. All transfers are done with I2C_RDWR ioctl,
+ * so no I2C_SLAVE switching is needed between chips.
+ *
+ */
+class I2CDevBus final : public I2CBus
+{
+    private:
+	int fileh;
+
+    public:
+	I2CDevBus(uint8_t busn);
+	~I2CDevBus();
+
+	int transfer(struct i2c_msg *msgs, unsigned count);
+};
+
+};
+
+#endif
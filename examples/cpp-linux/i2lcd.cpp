@@ -2,6 +2,8 @@
 #include <unistd.h>
 #include <exception>
 #include <i2lcd.h>
+#include <framebuffer.h>
+#include <lcdcore.h>
 
 using namespace i2lcd;
 
@@ -10,184 +12,58 @@ const uint8_t potBTransTable[64] = {0,13,21,27,30,34,36,38,40,42,43,45,46,47,48,
 
 
 /**
- * @brief Helper function to space argument bits apart, so we can interleve
- *        them with second argument.
- * @param argument to interleve
+ * @brief Helper function to find level which translation table
+ *        maps to given wiper position.
+ * @param translation table
+ * @param wiper position
+ * @return lowest level giving at least given wiper position
  */
-static uint16_t _partbyte(uint16_t n)
+static uint8_t _level(const uint8_t *table, uint8_t wiper)
 {
-    n &= 0x00ff;
-    n = (n | (n << 8)) & 0x00ff00ff;
-    n = (n | (n << 4)) & 0x0f0f0f0f;
-    n = (n | (n << 2)) & 0x33333333;
-    n = (n | (n << 1)) & 0x55555555;
-    return n;
-}
-
-/**
- * @brief Reverse _partbyte() method, to get two arguments back in
- *        deinterleave operation.
- * @param argument to deinterleave
- */
-static uint16_t _unpartbyte(uint16_t n)
-{
-    n &= 0x5555;
-    n = (n ^ (n >> 1)) & 0x33333333;
-    n = (n ^ (n >> 2)) & 0x0f0f0f0f;
-    n = (n ^ (n >> 4)) & 0x00ff00ff;
-    n = (n ^ (n >> 8)) & 0x0000ffff;
-    return n;
-}
-
-/**
- * @brief interleves bits from width and height of the display
- *        and for respresenting them as one integer value
- * @param width of the display
- * @param height of the display
- * @return interleved values of width and height
- */
-static uint16_t _interleave(uint8_t width, uint8_t height)
-{
-    return _partbyte(width) | (_partbyte(height) << 1);
-}
-
-/**
- * @brief opposite function to the _interleave(). Returns 16 bit value
- *        with most significant byte set to width of the display
- *        and last significant byte set to height of the display.
- * @param value of interleved width and height
- * @return two bytes in 16 bit word.
- */
-static uint16_t _deinterleave(uint16_t n)
-{
-    return (_unpartbyte(n) << 8) | _unpartbyte(n >> 1);
-}
-
-
-
-/**
- * @brief LcdType class constructor.
- * This class maintains an LCD configuration
- * rows addresses. Rows and Columns counters etc
- *
- **/
-LcdType::LcdType(t_LCDType type) : lcdtype(type)
-{
-    t_LCDType t = type;
-    if(type == D16x1)
-        t = D8x2;
-
-    uint16_t tmp = _deinterleave((uint16_t) t);
-    *((uint32_t*)rowaddr) = 0x00;
-
-    columns = tmp >> 8;
-    rows = (tmp & 0x00ff) ? (tmp & 0x00ff) : 1; //D16x0 means D16x1 with linear addressing
-    lines = rows > 1;
-
-    if (type == D6x1 || type == D8x1 || type == D16x0)
-        return;
-
-    rowaddr[1] = 0x40;
-    if (type == D8x2 || type == D16x1 || type == D16x2 || type == D20x2 || type == D24x2 || type == D40x2)
-        return;
-
-
-    rowaddr[2] = 0x10;
-    rowaddr[3] = 0x50;
-
-    if (type == D12x4)
-    {
-        rowaddr[2] -= 4;
-        rowaddr[3] -= 4;
-    }
-
-    if (type == D20x4)
-    {
-        rowaddr[2] |= 4;
-        rowaddr[3] |= 4;
-    }
-}
-
-/**
- * @brief [] operator for LcdType class
- * returns address of row given as index or
- * throws RowOutOfRange exception if given row is
- * is beyond actual range of an LCD.
- * @param row
- * @return address of a row in DDRAM
- **/
-uint8_t LcdType::operator[](uint8_t row) const
-{
-    if (row > rows) throw RowOutOfRange();
-    return rowaddr[row];
-}
-
-/**
- * @brief Method returns address of byte in DDRAM
- * by given column and row number.
- * throws Row/ColumnOutOfRange exception if
- * given row/column values are beyond actual
- * range of an LCD
- * @param column
- * @param row
- * @return address of a row in DDRAM
- **/
-uint8_t LcdType::ddAddress(uint8_t column, uint8_t row) const
-{
-    if (row > rows) throw RowOutOfRange();
-    if (column > columns) throw ColumnOutOfRange();
-    return rowaddr[row] + column;
-}
+    uint8_t i;
 
-/**
- * @brief Method returns address of CGRAM by given
- * character number and row in character.
- * It can throw one of two excetpions:
- * CharacterOutOfRange - when given character has
- *                       number greater than 7
- * or RowOutOfNumber - when given row exceeds
- *                     maximum height of character
- *                     (usually 7)
- * @param character
- * @param row
- * @return address of a byte in CGRAM
- **/
-uint8_t LcdType::cgAddress(uint8_t character, uint8_t row) const
-{
-    if (row > 7) throw RowOutOfRange();
-    if (character > 7)  throw CharacterOutOfRange();
-    return (8 * character) + row;
+    for(i = 0; i < 0x3f && table[i] < wiper; i++) {};
+    return i;
 }
 
-void I2Lcd::_init(void)
+void I2Lcd::_init(const char *statedir)
 {
     setDirection(CPORT, IRS);
     setDirection(DPORT, 0x00);
-    setOutput(CPORT, (UD | BACKLIGHT_CS | CONTRAST_CS));
-
-    bpot = new Potentiometer(*this, BACKLIGHT_CS, UD);
-    cpot = new Potentiometer(*this, CONTRAST_CS, UD);
+    port = new ControlPort(*this, (UD | BACKLIGHT_CS | CONTRAST_CS), UD);
 
-    control = getOutput(CPORT);
-    setOutput(CPORT, control);
+    potstate = new PotState(statedir, getBus(), getAddress());
+    bpot = new Potentiometer(*port, BACKLIGHT_CS, potstate->record(BACKLIGHT_CS));
+    cpot = new Potentiometer(*port, CONTRAST_CS, potstate->record(CONTRAST_CS));
+    blevel = _level(potBTransTable, bpot->get());
+    clevel = _level(potCTransTable, 0x3f - cpot->get());
 
     row = 0;
     column = 0;
     memset(commands, 0, 8);
+    screen = new FrameBuffer(lcdtype.getColumns(), lcdtype.getRows());
+    screenvalid = false;
+    busypoll = false;
+    waitflag = false;
+    readyat = 0;
 }
 
 /**
  * @brief I2Lcd class constructor.
  * Requires bus number, address of the i2lcd module
  * and type of an LCD.
+ * If directory for state files is given, last wiper positions
+ * of potentiometers are kept there and homing sweep of pots
+ * is skipped on next construction.
  *
  * @param bus number
  * @param address I2C address of module
  * @param type type of an LCD connected to bus
+ * @param statedir directory for pots state file or NULL
  **/
-I2Lcd::I2Lcd(uint8_t bus, uint8_t address, t_LCDType type) : PCA9535(bus, address), lcdtype(LcdType(type)), control(0), waitflag(0)
+I2Lcd::I2Lcd(uint8_t bus, uint8_t address, t_LCDType type, const char *statedir) : PCA9535(bus, address), lcdtype(LcdType(type))
 {
-    _init();
+    _init(statedir);
 }
 
 /**
@@ -199,12 +75,42 @@ I2Lcd::I2Lcd(uint8_t bus, uint8_t address, t_LCDType type) : PCA9535(bus, addres
  * @param address I2C address of module
  * @param number of columns
  * @param number of rows the display has
+ * @param statedir directory for pots state file or NULL
  **/
-I2Lcd::I2Lcd(uint8_t bus, uint8_t address, uint8_t columns, uint8_t rows) : PCA9535(bus, address),
-                                                                            control(0), waitflag(0)
+I2Lcd::I2Lcd(uint8_t bus, uint8_t address, uint8_t columns, uint8_t rows, const char *statedir) : PCA9535(bus, address)
 {
     lcdtype = LcdType((t_LCDType)_interleave(columns, rows));
-    _init();
+    _init(statedir);
+}
+
+/**
+ * @brief I2Lcd class constructor for module sharing
+ * I2C bus with other modules.
+ *
+ * @param bus interface
+ * @param address I2C address of module
+ * @param type type of an LCD connected to bus
+ * @param statedir directory for pots state file or NULL
+ **/
+I2Lcd::I2Lcd(I2CBus &bus, uint8_t address, t_LCDType type, const char *statedir) : PCA9535(bus, address), lcdtype(LcdType(type))
+{
+    _init(statedir);
+}
+
+/**
+ * @brief I2Lcd class constructor for module sharing
+ * I2C bus with other modules.
+ *
+ * @param bus interface
+ * @param address I2C address of module
+ * @param number of columns
+ * @param number of rows the display has
+ * @param statedir directory for pots state file or NULL
+ **/
+I2Lcd::I2Lcd(I2CBus &bus, uint8_t address, uint8_t columns, uint8_t rows, const char *statedir) : PCA9535(bus, address)
+{
+    lcdtype = LcdType((t_LCDType)_interleave(columns, rows));
+    _init(statedir);
 }
 
 /**
@@ -217,9 +123,12 @@ I2Lcd::~I2Lcd()
 {
     bpot->set(0x00);
     cpot->set(0x3f);
-    setOutput(CPORT, ~(PWR));
+    port->write(~(PWR));
     if (cpot) delete cpot;
     if (bpot) delete bpot;
+    if (potstate) delete potstate;
+    if (port) delete port;
+    if (screen) delete screen;
     setDirection(CPORT, 0xFF);
     setDirection(DPORT, 0xFF);
 }
@@ -228,15 +137,15 @@ I2Lcd::~I2Lcd()
  * @brief Changes CPORT outputs to control and LCD
  * expects values to set/unset and boolean
  * value controling if value should be set
- * or unset.
+ * or unset. Pending pot moves ride along
+ * the same write.
  * This method is private
  * @param flags
  * @param value
  **/
 void I2Lcd::_control(uint8_t flags, bool value)
 {
-    control = value ? (control | flags) : (control & (~flags));
-    setOutput(CPORT, control);
+    port->set(flags, value);
 }
 
 /**
@@ -250,17 +159,7 @@ void I2Lcd::_control(uint8_t flags, bool value)
  **/
 void I2Lcd::_command(t_Command command, uint8_t value)
 {
-    while(waitflag && (_status() & BUSY_FLAG)) {};
-    value |= (1 << (uint8_t) command);
-    usleep(1);
-    _control(RS|RW, 0);
-    usleep(1);
-    _control(EN, 1);
-    usleep(1);
-    setOutput(DPORT, value);
-    usleep(2);
-    _control(EN, 0);
-    commands[(uint8_t)command] = value;
+    strobe(false, value | (1 << (uint8_t) command));
 }
 
 /**
@@ -282,17 +181,8 @@ void I2Lcd::_writeblock(const char *block, uint8_t len)
 {
     uint8_t i;
 
-    _control(RS, 1);
-    _control(RW, 0);
     for(i=0; i<len; i++)
-    {
-	_control(EN, 1);
-	usleep(1);
-	setOutput(DPORT, block[i]);
-	_control(EN, 0);
-	usleep(1);
-    }
-    _control(RS | RW | EN, 0);
+	strobe(true, block[i]);
 }
 
 /**
@@ -328,7 +218,12 @@ uint8_t I2Lcd::_status(void)
  *
  * @param value
  **/
-void I2Lcd::setBacklight(uint8_t value) { bpot->set(potBTransTable[value]); };
+void I2Lcd::setBacklight(uint8_t value)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    postBacklight(value);
+    port->flush();
+}
 
 /**
  * @brief Set contrast of and LCD.
@@ -342,7 +237,102 @@ void I2Lcd::setBacklight(uint8_t value) { bpot->set(potBTransTable[value]); };
  *
  * @param value
  **/
-void I2Lcd::setContrast(uint8_t value) { cpot->set(0x3f - potCTransTable[value]); };
+void I2Lcd::setContrast(uint8_t value)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    postContrast(value);
+    port->flush();
+}
+
+/**
+ * @brief Set backlight brightness and contrast together.
+ * Values have same meaning as for setBacklight() and
+ * setContrast(). When both pots move in the same direction
+ * they're driven by single pulse train, which halves
+ * bus traffic compared to separate calls.
+ * Method waits until both wipers get to new positions.
+ *
+ * @param backlight
+ * @param contrast
+ **/
+void I2Lcd::setLevels(uint8_t backlight, uint8_t contrast)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    postLevels(backlight, contrast);
+    port->flush();
+}
+
+/**
+ * @brief Request backlight brightness change without
+ * waiting for it. Wiper pulses ride along following
+ * LCD writes, or are sent by flushLevels().
+ * Method takes no lock and can be called from any thread.
+ * Values above 0x3f are clamped.
+ *
+ * @param value
+ **/
+void I2Lcd::postBacklight(uint8_t value)
+{
+    if (value > 0x3f)
+	value = 0x3f;
+    bpot->post(potBTransTable[value]);
+    blevel = value;
+}
+
+/**
+ * @brief Request contrast change without waiting for it.
+ * Same as postBacklight() but for contrast.
+ *
+ * @param value
+ **/
+void I2Lcd::postContrast(uint8_t value)
+{
+    if (value > 0x3f)
+	value = 0x3f;
+    cpot->post(0x3f - potCTransTable[value]);
+    clevel = value;
+}
+
+/**
+ * @brief Request backlight and contrast change without
+ * waiting for it. Moves in the same direction share
+ * pulses on UD line.
+ *
+ * @param backlight
+ * @param contrast
+ **/
+void I2Lcd::postLevels(uint8_t backlight, uint8_t contrast)
+{
+    postBacklight(backlight);
+    postContrast(contrast);
+}
+
+/**
+ * @brief Finish posted backlight and contrast changes
+ * with dedicated bus writes.
+ *
+ **/
+void I2Lcd::flushLevels(void)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    port->flush();
+}
+
+/**
+ * @brief Force homing sweep of both potentiometers,
+ * even if their positions were restored from state file.
+ * Use it when module lost power while state file was kept.
+ * Both pots end up at 0.
+ *
+ **/
+void I2Lcd::rehome(void)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    bpot->home();
+    cpot->home();
+    blevel = _level(potBTransTable, bpot->get());
+    clevel = _level(potCTransTable, 0x3f - cpot->get());
+}
 
 /**
  * @brief Switch power of an LCD on or off.
@@ -354,11 +344,12 @@ void I2Lcd::setContrast(uint8_t value) { cpot->set(0x3f - potCTransTable[value])
  **/
 void I2Lcd::power(bool value)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
         _control(PWR, value);
-	if (control & PWR)
+	screenvalid = false;
+	waitflag = false;
+	if (port->get() & PWR)
 	    init();
-	else
-	    waitflag = 0;
 }
 
 /**
@@ -370,23 +361,12 @@ void I2Lcd::power(bool value)
  **/
 void I2Lcd::init(void)
 {
-    usleep(4500);
-    uint8_t fn = FS_DL | (lcdtype.getLine() ? FS_N : 0);
-    _command(FUNCTION_SET, fn);
-    usleep(5000);
-    _command(FUNCTION_SET, fn);
-    usleep(4500);
-    _command(FUNCTION_SET, fn);
-    usleep(4500);
-    _command(DISPLAY_ONOFF, 0x00);
-    usleep(6000);
-    _command(CLEAR_DISPLAY, 0x00);
-    usleep(30000);
-    _command(ENTRY_MODE_SET, EMS_ID);
-    usleep(6000);
-    _command(DISPLAY_ONOFF, DOO_D);
-    usleep(6000);
-    waitflag = 1;
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+
+    waitflag = false;
+    lcdInit(lcdtype.getLine(), [this](uint8_t value) { strobe(false, value); });
+    screen->clear();
+    waitflag = true;
 }
 
 
@@ -399,6 +379,7 @@ void I2Lcd::init(void)
  **/
 void I2Lcd::setCursor(uint8_t pcol, uint8_t prow)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     _command(SET_DDRAM_ADDRESS, lcdtype.ddAddress(pcol, prow));
     column = pcol;
     row = prow;
@@ -413,11 +394,73 @@ void I2Lcd::setCursor(uint8_t pcol, uint8_t prow)
  **/
 void I2Lcd::home(void)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     _command(CURSOR_HOME, 0x00);
     column = 0;
     row = 0;
 }
 
+/**
+ * @brief Shift whole display by one position, every row
+ * moves. DDRAM content and addresses stay, so show() and
+ * print() keep writing where they did, home() and clear()
+ * return the display to its position.
+ *
+ * @param right true to move content right, false to move left
+ **/
+void I2Lcd::shiftDisplay(bool right)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    _command(CURSOR_DISPLAY_SHIFT, CDS_SC | (right ? CDS_RL : 0));
+}
+
+/**
+ * @brief Write data at DDRAM address, including addresses
+ * beyond visible columns. Address counter continues from
+ * the end of the line to the next one, caller splits writes
+ * at line end. Cursor position is restored afterwards.
+ *
+ * @param address DDRAM address
+ * @param data characters
+ * @param len number of characters
+ **/
+void I2Lcd::writeDD(uint8_t address, const char *data, uint8_t len)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    uint8_t i, r;
+
+    _command(SET_DDRAM_ADDRESS, address);
+    _writeblock(data, len);
+    for (i = 0; i < len; i++, address++)
+	for (r = 0; r < rows(); r++)
+	    if (address >= lcdtype[r] && address < lcdtype[r] + columns())
+		screen->put(address - lcdtype[r], r, data[i]);
+    _command(SET_DDRAM_ADDRESS, lcdtype.ddAddress(column, row));
+}
+
+/**
+ * @brief Write characters at DDRAM address already known to
+ * belong to given position, without range checks. Used by
+ * FixedLcd, which resolves addresses at compile time.
+ * This method is protected
+ *
+ * @param address DDRAM address of column and row
+ * @param pcol column
+ * @param prow row
+ * @param text characters, must fit the row
+ * @param len number of characters
+ **/
+void I2Lcd::_put(uint8_t address, uint8_t pcol, uint8_t prow, const char *text, uint8_t len)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+
+    _command(SET_DDRAM_ADDRESS, address);
+    _writeblock(text, len);
+    screen->put(pcol, prow, text, len);
+    column = pcol + len < columns() ? pcol + len : columns() - 1;
+    row = prow;
+}
+
 /**
  * @brief Clear display by filling DDRAM with 0x20
  * characters (spaces) and set column and row
@@ -426,7 +469,9 @@ void I2Lcd::home(void)
  **/
 void I2Lcd::clear(void)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     _command(CLEAR_DISPLAY, 0x00);
+    screen->clear();
     column = 0;
     row = 0;
 }
@@ -440,8 +485,39 @@ void I2Lcd::clear(void)
  **/
 void I2Lcd::setGC(uint8_t character, const char *bitmap)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     _command(SET_CGRAM_ADDRESS, lcdtype.cgAddress(character, 0));
     _writeblock(bitmap, 8);
+    screen->setGC(character, bitmap);
+}
+
+/**
+ * @brief Set some rows of user characters. CGRAM address
+ * increments over character boundary, so rows may continue
+ * into following characters, up to the end of CGRAM.
+ *
+ * @param character number of first character
+ * @param first first row of first character
+ * @param rows row bitmaps
+ * @param count number of rows
+ **/
+void I2Lcd::setGCRows(uint8_t character, uint8_t first, const char *rows, uint8_t count)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    uint8_t address = lcdtype.cgAddress(character, first);
+    char bitmap[8];
+    uint8_t i;
+
+    if (count > 64 - address)
+	count = 64 - address;
+    _command(SET_CGRAM_ADDRESS, address);
+    _writeblock(rows, count);
+    for (i = 0; i < count; i++, address++)
+    {
+	memcpy(bitmap, screen->glyph(address / 8), 8);
+	bitmap[address % 8] = rows[i];
+	screen->setGC(address / 8, bitmap);
+    }
 }
 
 /**
@@ -451,6 +527,7 @@ void I2Lcd::setGC(uint8_t character, const char *bitmap)
  **/
 void I2Lcd::blink(bool value)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     _command(DISPLAY_ONOFF, value ? (commands[DISPLAY_ONOFF] | DOO_B) : (commands[DISPLAY_ONOFF] & (~DOO_B)));
 }
 
@@ -461,6 +538,7 @@ void I2Lcd::blink(bool value)
  **/
 void I2Lcd::cursor(bool value)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     _command(DISPLAY_ONOFF, value ? (commands[DISPLAY_ONOFF] | DOO_C) : (commands[DISPLAY_ONOFF] & (~DOO_C)));
 }
 
@@ -472,6 +550,7 @@ void I2Lcd::cursor(bool value)
  **/
 void I2Lcd::display(bool value)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     _command(DISPLAY_ONOFF, value ? (commands[DISPLAY_ONOFF] | DOO_D) : (commands[DISPLAY_ONOFF] & (~DOO_D)));
 }
 
@@ -484,10 +563,12 @@ void I2Lcd::display(bool value)
  **/
 string I2Lcd::getRow(uint8_t row)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     uint8_t i;
     string s;
 
     _command(SET_DDRAM_ADDRESS, lcdtype.ddAddress(0, row));
+    _ready();
     _control(RS | RW, 1);
     setDirection(DPORT, 0xFF);
     for(i=0; i<lcdtype.getColumns(); i++)
@@ -510,13 +591,16 @@ string I2Lcd::getRow(uint8_t row)
  * current row, it will continue to print rest
  * at new row. At last row it will reset row to
  * 0 again, effectively wrapping string around
- * an LCD.
+ * an LCD. DDRAM address is set once per run
+ * of characters on a row, it increments itself.
  *
- * @param string value
+ * @param value text, any string or character array
  **/
-void I2Lcd::print(string value)
+void I2Lcd::print(std::string_view value)
 {
-    std::string::iterator i;
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    std::string_view::const_iterator i;
+    bool address = true;
     char c;
 
     uint8_t cl, rw, idc = 0;
@@ -531,16 +615,23 @@ void I2Lcd::print(string value)
 	{
 	    rw = (rw + 1) % rows();
 	    cl = 0;
+	    address = true;
 	    continue;
 	} else
 	{
-	    _command(SET_DDRAM_ADDRESS, lcdtype.ddAddress(cl, rw));
+	    if (address)
+	    {
+		_command(SET_DDRAM_ADDRESS, lcdtype.ddAddress(cl, rw));
+		address = false;
+	    }
 	    _writeblock(&c, 1);
+	    screen->put(cl, rw, c);
 	    cl++;
 	    if(cl == columns())
 	    {
 		if (idc == 0) idc = 1;
 		cl = 0;
+		address = true;
 	    }
 	}
 	if (idc)
@@ -554,6 +645,93 @@ void I2Lcd::print(string value)
     _command(SET_DDRAM_ADDRESS, lcdtype.ddAddress(column, row));
 }
 
+/**
+ * @brief Send single command (rs false) or data byte (rs true)
+ * to an LCD. Instead of polling busy flag, strobe remembers when
+ * LCD finishes this operation, execTime() with margin, and next
+ * strobe sleeps only if it comes earlier. Callers like BusScheduler
+ * use ready() to avoid sleeping at all. setBusyPolling() adds busy
+ * flag check before every operation.
+ * Operation is encoded by lcdEncode() into one message, RS setup,
+ * EN rise with data and EN fall, pot pulses ride along its CPORT
+ * writes.
+ *
+ * @param rs false for command, true for data
+ * @param value command with its bit set or data byte
+ **/
+void I2Lcd::strobe(bool rs, uint8_t value)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    uint8_t c = port->get(), buf[LCDCORE_OPBYTES];
+    int state = (c & (RW | EN)) ? -1 : (c & RS) != 0;
+    struct i2c_msg msg;
+    int8_t i;
+
+    msg.addr = getAddress();
+    msg.flags = 0;
+    msg.len = lcdEncode(buf, c & ~(RS | RW | EN), state, rs, value,
+	[this](uint8_t cport) { return port->advance(cport); }) - buf;
+    msg.buf = buf;
+    _ready();
+    getInterface().transfer(&msg, 1);
+    readyat = monotonicNs() + (uint64_t) execTime(rs, value) * 1000;
+
+    if (!rs)
+	for (i = 7; i >= 0; i--)
+	    if (value & (1 << i))
+	    {
+		commands[i] = value;
+		break;
+	    }
+}
+
+/**
+ * @brief Sleep until LCD finishes operation sent by last strobe().
+ * With setBusyPolling() busy flag is then also polled, once init()
+ * is done, for modules slower than execTime() expects.
+ * This method is private
+ **/
+void I2Lcd::_ready(void)
+{
+    sleepUntil(readyat);
+    if (busypoll && waitflag)
+	while (_status() & BUSY_FLAG) {};
+}
+
+/**
+ * @brief Check if LCD finished operation sent by last strobe()
+ *
+ * @return true if next strobe won't have to wait
+ **/
+bool I2Lcd::ready(void) const
+{
+    return monotonicNs() >= readyat;
+}
+
+/**
+ * @brief Show frame on the display. Only glyph bytes
+ * and runs of cells which differ from what display
+ * already shows are sent. After power on whole frame
+ * is sent once.
+ *
+ * @param frame to show
+ **/
+void I2Lcd::show(const FrameBuffer &frame)
+{
+    std::lock_guard<std::recursive_mutex> guard(buslock);
+    size_t i;
+
+    ops.clear();
+    screen->update(frame, lcdtype, ops, !screenvalid);
+    screenvalid = true;
+    if (ops.empty())
+	return;
+
+    for (i = 0; i < ops.size(); i++)
+	strobe(ops[i].rs, ops[i].value);
+    strobe(false, (1 << SET_DDRAM_ADDRESS) | lcdtype.ddAddress(column, row));
+}
+
 /**
  * @brief Return current row content. Subsequent call
  * of this function will return next row, until
@@ -564,6 +742,7 @@ void I2Lcd::print(string value)
  **/
 string I2Lcd::getRow(void)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     string s = getRow(row);
     row = (row + 1) % lcdtype.getRows();
     return s;
@@ -584,6 +763,7 @@ string I2Lcd::operator[](uint8_t row)
 
 void I2Lcd::_dump(void)
 {
+    std::lock_guard<std::recursive_mutex> guard(buslock);
     uint8_t i;
     string s;
 
@@ -1,8 +1,14 @@
 #ifndef __I2LCD_H__
-#define __i2LCD_H__
+#define __I2LCD_H__
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <time.h>
+#include <mutex>
+#include <atomic>
+#include <vector>
 
 #include <pca9535.h>
 #include <pots.h>
@@ -45,12 +51,82 @@ enum t_Command {
 
 #define BUSY_FLAG	(1 << 7)
 
+#define EXEC_CLEAR_US	1640
+#define EXEC_CMD_US	43
+/* execution times above are for 270 kHz oscillator, slowest modules run at 190 kHz */
+#define EXEC_MARGIN_PCT	50
+
 #define POWERON	1
 #define POWEROFF 0
 
 namespace i2lcd
 {
 
+class FrameBuffer;
+
+/**
+ * @brief Helper function to space argument bits apart, so we can interleve
+ *        them with second argument.
+ * @param argument to interleve
+ */
+constexpr uint16_t _partbyte(uint16_t n)
+{
+    n &= 0x00ff;
+    n = (n | (n << 8)) & 0x00ff00ff;
+    n = (n | (n << 4)) & 0x0f0f0f0f;
+    n = (n | (n << 2)) & 0x33333333;
+    n = (n | (n << 1)) & 0x55555555;
+    return n;
+}
+
+/**
+ * @brief Reverse _partbyte() method, to get two arguments back in
+ *        deinterleave operation.
+ * @param argument to deinterleave
+ */
+constexpr uint16_t _unpartbyte(uint16_t n)
+{
+    n &= 0x5555;
+    n = (n ^ (n >> 1)) & 0x33333333;
+    n = (n ^ (n >> 2)) & 0x0f0f0f0f;
+    n = (n ^ (n >> 4)) & 0x00ff00ff;
+    n = (n ^ (n >> 8)) & 0x0000ffff;
+    return n;
+}
+
+/**
+ * @brief interleves bits from width and height of the display
+ *        and for respresenting them as one integer value
+ * @param width of the display
+ * @param height of the display
+ * @return interleved values of width and height
+ */
+constexpr uint16_t _interleave(uint8_t width, uint8_t height)
+{
+    return _partbyte(width) | (_partbyte(height) << 1);
+}
+
+/**
+ * @brief opposite function to the _interleave(). Returns 16 bit value
+ *        with most significant byte set to width of the display
+ *        and last significant byte set to height of the display.
+ * @param value of interleved width and height
+ * @return two bytes in 16 bit word.
+ */
+constexpr uint16_t _deinterleave(uint16_t n)
+{
+    return (_unpartbyte(n) << 8) | _unpartbyte(n >> 1);
+}
+
+
+/**
+ * @brief Single HD44780 operation: command (rs false) or data byte
+ */
+struct t_LcdOp {
+    bool rs;
+    uint8_t value;
+};
+
 enum t_LCDType {
     D6x1 = 22,
     D8x1 = 66,
@@ -140,17 +216,114 @@ class LcdType
 
     public:
         LcdType() {};
-	LcdType(t_LCDType);
-	uint8_t getRows() const { return rows; };
-	uint8_t getColumns() const { return columns; };
+	constexpr LcdType(t_LCDType);
+	constexpr t_LCDType getType() const { return lcdtype; };
+	constexpr uint8_t getRows() const { return rows; };
+	constexpr uint8_t getColumns() const { return columns; };
 
 	uint8_t getRowAddress(uint8_t number) const;
-	uint8_t getLine() const { return lines; };
-	uint8_t ddAddress(uint8_t column, uint8_t row) const;
-	uint8_t cgAddress(uint8_t character, uint8_t row) const;
-	uint8_t operator[](uint8_t row) const;
+	constexpr uint8_t getLine() const { return lines; };
+	constexpr uint8_t ddAddress(uint8_t column, uint8_t row) const;
+	constexpr uint8_t cgAddress(uint8_t character, uint8_t row) const;
+	constexpr uint8_t operator[](uint8_t row) const;
 };
 
+/**
+ * @brief LcdType class constructor.
+ * This class maintains an LCD configuration
+ * rows addresses. Rows and Columns counters etc
+ * Constructor is constexpr, so types known at
+ * compile time are decoded by the compiler
+ *
+ **/
+constexpr LcdType::LcdType(t_LCDType type) : lcdtype(type), columns(0), rows(0), lines(0), rowaddr{0, 0, 0, 0}
+{
+    t_LCDType t = type;
+    if(type == D16x1)
+        t = D8x2;
+
+    uint16_t tmp = _deinterleave((uint16_t) t);
+
+    columns = tmp >> 8;
+    rows = (tmp & 0x00ff) ? (tmp & 0x00ff) : 1; //D16x0 means D16x1 with linear addressing
+    lines = rows > 1;
+
+    if (type == D6x1 || type == D8x1 || type == D16x0)
+        return;
+
+    rowaddr[1] = 0x40;
+    if (type == D8x2 || type == D16x1 || type == D16x2 || type == D20x2 || type == D24x2 || type == D40x2)
+        return;
+
+
+    rowaddr[2] = 0x10;
+    rowaddr[3] = 0x50;
+
+    if (type == D12x4)
+    {
+        rowaddr[2] -= 4;
+        rowaddr[3] -= 4;
+    }
+
+    if (type == D20x4)
+    {
+        rowaddr[2] |= 4;
+        rowaddr[3] |= 4;
+    }
+}
+
+/**
+ * @brief [] operator for LcdType class
+ * returns address of row given as index or
+ * throws RowOutOfRange exception if given row is
+ * is beyond actual range of an LCD.
+ * @param row
+ * @return address of a row in DDRAM
+ **/
+constexpr uint8_t LcdType::operator[](uint8_t row) const
+{
+    if (row > rows) throw RowOutOfRange();
+    return rowaddr[row];
+}
+
+/**
+ * @brief Method returns address of byte in DDRAM
+ * by given column and row number.
+ * throws Row/ColumnOutOfRange exception if
+ * given row/column values are beyond actual
+ * range of an LCD
+ * @param column
+ * @param row
+ * @return address of a row in DDRAM
+ **/
+constexpr uint8_t LcdType::ddAddress(uint8_t column, uint8_t row) const
+{
+    if (row > rows) throw RowOutOfRange();
+    if (column > columns) throw ColumnOutOfRange();
+    return rowaddr[row] + column;
+}
+
+/**
+ * @brief Method returns address of CGRAM by given
+ * character number and row in character.
+ * It can throw one of two excetpions:
+ * CharacterOutOfRange - when given character has
+ *                       number greater than 7
+ * or RowOutOfNumber - when given row exceeds
+ *                     maximum height of character
+ *                     (usually 7)
+ * @param character
+ * @param row
+ * @return address of a byte in CGRAM
+ **/
+constexpr uint8_t LcdType::cgAddress(uint8_t character, uint8_t row) const
+{
+    if (row > 7) throw RowOutOfRange();
+    if (character > 7)  throw CharacterOutOfRange();
+    return (8 * character) + row;
+}
+
+
 /**
  * @class I2Lcd
  *
@@ -159,54 +332,144 @@ class LcdType
  * @brief Main module interface class.
  *
  * Class implements metohds for accessing LCD connected through I2LCD module
- *
+ * Every public method holds bus lock for its whole transfer, so other
+ * threads (like Fader) can interleave their own operations between them.
+ * Lock busLock() to group several calls into one uninterrupted sequence.
  *
  */
 class I2Lcd : public PCA9535
 {
+    friend class LcdMirror;
+
     private:
 	LcdType lcdtype;
+	PotState *potstate;
 	Potentiometer *cpot;
 	Potentiometer *bpot;
-	uint8_t control;
+	ControlPort *port;
+	std::atomic<uint8_t> blevel;
+	std::atomic<uint8_t> clevel;
 	uint8_t column;
 	uint8_t row;
-	bool waitflag;
 	uint8_t commands[8];
+	FrameBuffer *screen;
+	bool screenvalid;
+	bool busypoll;
+	bool waitflag;
+	uint64_t readyat;
+	std::vector<t_LcdOp> ops;
+	std::recursive_mutex buslock;
 
 	void _control(uint8_t flags, bool value);
 	void _command(t_Command command, uint8_t value);
 	uint8_t _status(void);
 	void _writeblock(const char *block, uint8_t len);
         void _readblock(const char *block, uint8_t len);
-        void _init(void);
+        void _init(const char *statedir);
+	void _ready(void);
 
+    protected:
+	void _put(uint8_t address, uint8_t pcol, uint8_t prow, const char *text, uint8_t len);
 
     public:
-	I2Lcd(uint8_t bus, uint8_t address, t_LCDType type);
-        I2Lcd(uint8_t bus, uint8_t address, uint8_t columns, uint8_t rows);
+	I2Lcd(uint8_t bus, uint8_t address, t_LCDType type, const char *statedir = NULL);
+        I2Lcd(uint8_t bus, uint8_t address, uint8_t columns, uint8_t rows, const char *statedir = NULL);
+	I2Lcd(I2CBus &bus, uint8_t address, t_LCDType type, const char *statedir = NULL);
+	I2Lcd(I2CBus &bus, uint8_t address, uint8_t columns, uint8_t rows, const char *statedir = NULL);
 	~I2Lcd();
 	uint8_t rows(void) {return lcdtype.getRows(); };
 	uint8_t columns(void) {return lcdtype.getColumns(); };
+	const LcdType &type(void) const { return lcdtype; };
 	void setBacklight(uint8_t value);
 	void setContrast(uint8_t value);
+	void setLevels(uint8_t backlight, uint8_t contrast);
+	void postBacklight(uint8_t value);
+	void postContrast(uint8_t value);
+	void postLevels(uint8_t backlight, uint8_t contrast);
+	void flushLevels(void);
+	uint8_t getBacklight(void) const { return blevel; };
+	uint8_t getContrast(void) const { return clevel; };
+	std::recursive_mutex &busLock(void) { return buslock; };
+	void rehome(void);
 	void setCursor(uint8_t pcol, uint8_t prow);
 	void setGC(uint8_t character, const char *bitmap);
+	void setGCRows(uint8_t character, uint8_t first, const char *rows, uint8_t count);
 	string getRow(uint8_t row);
 	string getRow(void);
 	void power(bool value);
 	void init(void);
 	void home(void);
+	void shiftDisplay(bool right);
+	void writeDD(uint8_t address, const char *data, uint8_t len);
 	void clear(void);
 	void blink(bool value);
 	void cursor(bool value);
 	void display(bool value);
-	void print(string value);
+	void print(std::string_view value);
+	void show(const FrameBuffer &frame);
+	FrameBuffer &getScreen(void) { return *screen; };
+	void strobe(bool rs, uint8_t value);
+	bool ready(void) const;
+	void setBusyPolling(bool value) { busypoll = value; };
+	static unsigned execTime(bool rs, uint8_t value);
 	string operator[](uint8_t row);
 
 	void _dump(void);
 };
 
+/**
+ * @brief Return time an LCD needs to execute command or
+ * data write, before it can accept next one. Nominal time
+ * is extended by EXEC_MARGIN_PCT for slow oscillators.
+ *
+ * @param rs false for command, true for data
+ * @param value command or data byte
+ * @return execution time in microseconds
+ **/
+inline unsigned I2Lcd::execTime(bool rs, uint8_t value)
+{
+    unsigned us = !rs && value && value < (1 << ENTRY_MODE_SET) ? EXEC_CLEAR_US : EXEC_CMD_US;
+
+    return us + us * EXEC_MARGIN_PCT / 100;
+}
+
+/**
+ * @brief Return monotonic time in nanoseconds. All readiness
+ * times (readyat) of the library are kept in this clock.
+ **/
+inline uint64_t monotonicNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Return monotonic time in milliseconds
+ **/
+inline uint64_t monotonicMs(void)
+{
+    return monotonicNs() / 1000000;
+}
+
+/**
+ * @brief Sleep until given monotonicNs() time, return at once
+ * when it already passed
+ *
+ * @param ns wake up time
+ **/
+inline void sleepUntil(uint64_t ns)
+{
+    struct timespec ts;
+
+    if (monotonicNs() >= ns)
+	return;
+    ts.tv_sec = ns / 1000000000;
+    ts.tv_nsec = ns % 1000000000;
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
 };
 
 
@@ -0,0 +1,109 @@
+#include <cstring>
+
+#include <layout.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Helper taking next line off the text. This method is private
+ *
+ * @param text remaining text, advanced past the line and its break
+ * @param width region width
+ * @return line without surrounding break spaces
+ **/
+std::string_view TextLayout::_line(std::string_view &text, uint8_t width) const
+{
+    size_t end, next, space;
+
+    end = text.find('\n');
+    if (end == std::string_view::npos)
+	end = text.size();
+    next = end < text.size() ? end + 1 : end;
+
+    if (end > width)
+    {
+	if (!wrap)
+	{
+	    /* cut, the rest of this line is dropped */
+	    std::string_view line = text.substr(0, end);
+	    text.remove_prefix(next);
+	    return line;
+	}
+	space = text.rfind(' ', width);
+	if (space == std::string_view::npos || space == 0)
+	    end = next = width;
+	else
+	{
+	    end = space;
+	    next = space;
+	    while (next < text.size() && text[next] == ' ')
+		next++;
+	}
+    }
+    std::string_view line = text.substr(0, end);
+    while (!line.empty() && line.back() == ' ')
+	line.remove_suffix(1);
+    text.remove_prefix(next);
+    return line;
+}
+
+/**
+ * @brief Lay text out into region of the frame
+ *
+ * @param frame
+ * @param region cells to fill, clipped to the frame
+ * @param text
+ * @return true when whole text fits, false when it was cut
+ **/
+bool TextLayout::put(FrameBuffer &frame, const t_Region &region, std::string_view text) const
+{
+    std::string_view line;
+    uint8_t width, height, r, pad, n;
+    char *cells;
+    bool more, fits = true;
+
+    if (region.column >= frame.columns() || region.row >= frame.rows())
+	return text.empty();
+    width = region.width < frame.columns() - region.column ? region.width : frame.columns() - region.column;
+    height = region.height < frame.rows() - region.row ? region.height : frame.rows() - region.row;
+    if (!width || !height)
+	return text.empty();
+
+    for (r = 0; r < height; r++)
+    {
+	cells = frame.row(region.row + r) + region.column;
+	memset(cells, ' ', width);
+	if (text.empty())
+	    continue;
+
+	line = _line(text, width);
+	/* line is cut, or text goes on below the last row */
+	more = line.size() > width || (r == height - 1 && !text.empty());
+	if (more && line.size() >= width)
+	    line = line.substr(0, width - 1);
+	n = line.size() + more;
+	pad = align == ALIGN_LEFT ? 0 : (width - n) / (align == ALIGN_CENTER ? 2 : 1);
+	memcpy(cells + pad, line.data(), line.size());
+	if (more)
+	{
+	    cells[pad + line.size()] = ellipsis;
+	    fits = false;
+	}
+    }
+    return fits && text.empty();
+}
+
+/**
+ * @brief Lay text out into whole row of the frame, like status line
+ *
+ * @param frame
+ * @param row
+ * @param text
+ * @return true when whole text fits
+ **/
+bool TextLayout::put(FrameBuffer &frame, uint8_t row, std::string_view text) const
+{
+    t_Region region = {0, row, frame.columns(), 1};
+
+    return put(frame, region, text);
+}
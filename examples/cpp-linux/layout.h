@@ -0,0 +1,73 @@
+#ifndef __LAYOUT_H__
+#define __LAYOUT_H__
+
+#include <cstdint>
+#include <string_view>
+
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+/**
+ * @brief Horizontal alignment of laid out lines
+ */
+enum t_Align {
+    ALIGN_LEFT,
+    ALIGN_CENTER,
+    ALIGN_RIGHT,
+};
+
+/**
+ * @brief Rectangle of cells in a frame
+ */
+struct t_Region {
+    uint8_t column;
+    uint8_t row;
+    uint8_t width;
+    uint8_t height;
+};
+
+/**
+ * @class TextLayout
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Text laid out into region of FrameBuffer.
+ *
+ * Lines are broken at '\n' and, with word wrap, at spaces before the
+ * region edge, words longer than the region are broken at the edge.
+ * Without wrap each line is cut at the edge. When text doesn't fit, the
+ * last visible line ends with ellipsis character, which may be a user
+ * character loaded with ELLIPSIS_GLYPH. Lines are aligned within the
+ * region and unused cells are filled with spaces.
+ *
+ * Text is read through string_view and cells are written straight into
+ * frame rows, nothing is allocated or copied in between.
+ *
+ */
+class TextLayout
+{
+    private:
+	t_Align align;
+	bool wrap;
+	char ellipsis;
+
+	std::string_view _line(std::string_view &text, uint8_t width) const;
+
+    public:
+	static constexpr char ELLIPSIS_GLYPH[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x00};
+
+	TextLayout(t_Align align = ALIGN_LEFT, bool wrap = true, char ellipsis = '.') :
+	    align(align), wrap(wrap), ellipsis(ellipsis) {};
+
+	void setAlign(t_Align value) { align = value; };
+	void setWrap(bool value) { wrap = value; };
+	void setEllipsis(char value) { ellipsis = value; };
+
+	bool put(FrameBuffer &frame, const t_Region &region, std::string_view text) const;
+	bool put(FrameBuffer &frame, uint8_t row, std::string_view text) const;
+};
+
+};
+
+#endif
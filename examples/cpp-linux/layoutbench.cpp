@@ -0,0 +1,123 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <string>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <framebuffer.h>
+#include <layout.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Status screen of 20x4 display updated at high rate: centered title,
+ * formatted load and temperature line, and word wrapped message below.
+ * TextLayout into FrameBuffer is compared with std::string building and
+ * print(), first in memory (CPU time and heap allocations per update),
+ * then on simulated 100 kHz bus with I2Lcd::show() versus setCursor()
+ * and print() of every row.
+ *
+ * usage: layoutbench [updates]
+ */
+
+static unsigned long allocations;
+
+void *operator new(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+
+    allocations++;
+    if (!p)
+	throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+static const char *notices[] = {
+    "Backup finished, next run at 02:00",
+    "Fan 2 speed low, check air filter soon",
+};
+
+static void _layout(const TextLayout &center, const TextLayout &wrap, FrameBuffer &frame, unsigned i)
+{
+    char line[24];
+    int n;
+
+    center.put(frame, 0, "Server rack 3");
+    n = snprintf(line, sizeof(line), "CPU %3u%% T %4.1fC", i % 100, 40 + (i % 50) * 0.1);
+    center.put(frame, 1, std::string_view(line, n));
+    wrap.put(frame, {0, 2, 20, 2}, notices[(i / 64) % 2]);
+}
+
+static void _strings(FrameBuffer &frame, unsigned i)
+{
+    std::string title = "Server rack 3";
+    std::string status = "CPU " + std::to_string(i % 100) + "% T " + std::to_string(40 + (i % 50) * 0.1).substr(0, 4) + "C";
+    std::string message = notices[(i / 64) % 2];
+
+    frame.print(0, 0, std::string((20 - title.size()) / 2, ' ') + title + std::string(20, ' ').substr(0, 20 - (20 - title.size()) / 2 - title.size()));
+    frame.print(0, 1, (status + std::string(20, ' ')).substr(0, 20));
+    frame.print(0, 2, (message + std::string(40, ' ')).substr(0, 40));
+}
+
+int main(int argc, char **argv)
+{
+    unsigned updates = argc > 1 ? atoi(argv[1]) : 200000;
+    TextLayout center(ALIGN_CENTER, false), wrap(ALIGN_LEFT, true);
+    FrameBuffer frame(20, 4);
+    unsigned long before;
+    unsigned i, mode;
+    double t;
+
+    printf("path       ns/update  allocations/update\n");
+    for (mode = 0; mode < 2; mode++)
+    {
+	before = allocations;
+	steady_clock::time_point start = steady_clock::now();
+	for (i = 0; i < updates; i++)
+	    if (mode)
+		_strings(frame, i);
+	    else
+		_layout(center, wrap, frame, i);
+	t = duration<double, std::nano>(steady_clock::now() - start).count();
+	printf("%-9s %10.1f %19.2f\n", mode ? "string" : "layout", t / updates, (double) (allocations - before) / updates);
+    }
+
+    SimBus bus(100000);
+    I2Lcd lcd(bus, 0x20, D20x4);
+    FrameBuffer shown(20, 4);
+
+    lcd.power(POWERON);
+    printf("\npath       bus bytes/update  bus ms/update\n");
+    for (mode = 0; mode < 2; mode++)
+    {
+	bus.resetCounters();
+	for (i = 0; i < 50; i++)
+	    if (mode)
+	    {
+		_strings(shown, i * 7);
+		for (uint8_t r = 0; r < 4; r++)
+		{
+		    lcd.setCursor(0, r);
+		    lcd.print(shown.text(r));
+		}
+	    } else
+	    {
+		_layout(center, wrap, shown, i * 7);
+		lcd.show(shown);
+	    }
+	printf("%-9s %17.1f %14.2f\n", mode ? "print" : "show", bus.getBytes() / 50.0, bus.getWireTime() / 1000000.0 / 50);
+    }
+}
@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <linesink.h>
+
+using namespace i2lcd;
+
+/**
+ * lcdcat - shows lines from stdin or named pipe on the display.
+ * Lines scroll up from the bottom row, "@<row> text" sets given row.
+ * With -f the pipe is created if needed and reopened whenever last
+ * writer closes it, so scripts can come and go:
+ *
+ *   lcdcat -f /run/lcd.fifo -d /run &
+ *   echo "@0 $(date +%T)" > /run/lcd.fifo
+ *
+ * usage: lcdcat [-b bus] [-a address] [-c columns] [-r rows]
+ *               [-d state directory] [-p refresh ms] [-f fifo] [-S]
+ *
+ * -S runs on simulated bus and prints display content at the end.
+ */
+int main(int argc, char **argv)
+{
+    unsigned bus = 1, address = 0x20, columns = 16, rows = 2, refresh = LINESINK_REFRESH_MS;
+    const char *statedir = NULL, *fifo = NULL;
+    bool simulated = false;
+    SimBus *sim = NULL;
+    I2Lcd *lcd;
+    int opt, fd;
+    uint8_t r;
+
+    while ((opt = getopt(argc, argv, "b:a:c:r:d:p:f:S")) != -1)
+	switch (opt)
+	{
+	    case 'b': bus = strtoul(optarg, NULL, 0); break;
+	    case 'a': address = strtoul(optarg, NULL, 0); break;
+	    case 'c': columns = strtoul(optarg, NULL, 0); break;
+	    case 'r': rows = strtoul(optarg, NULL, 0); break;
+	    case 'd': statedir = optarg; break;
+	    case 'p': refresh = strtoul(optarg, NULL, 0); break;
+	    case 'f': fifo = optarg; break;
+	    case 'S': simulated = true; break;
+	    default:
+		fprintf(stderr, "usage: %s [-b bus] [-a address] [-c columns] [-r rows] [-d statedir] [-p refresh ms] [-f fifo] [-S]\n", argv[0]);
+		return 1;
+	}
+
+    try {
+	if (simulated)
+	{
+	    sim = new SimBus(100000, bus);
+	    lcd = new I2Lcd(*sim, address, columns, rows, statedir);
+	} else
+	    lcd = new I2Lcd(bus, address, columns, rows, statedir);
+	lcd->power(POWERON);
+	lcd->clear();
+    } catch (exception &e) {
+	fprintf(stderr, "%s: can't open display on bus %u address 0x%02x\n", argv[0], bus, address);
+	return 1;
+    }
+
+    LineSink sink(*lcd, refresh);
+
+    if (!fifo)
+	sink.run(STDIN_FILENO);
+    else
+    {
+	if (mkfifo(fifo, 0666) < 0 && errno != EEXIST)
+	{
+	    perror(fifo);
+	    return 1;
+	}
+	while ((fd = open(fifo, O_RDONLY | O_CLOEXEC)) >= 0)
+	{
+	    bool ok = sink.run(fd);
+
+	    close(fd);
+	    if (!ok)
+		break;
+	}
+    }
+
+    if (sim)
+    {
+	for (r = 0; r < rows; r++)
+	    printf("|%s|\n", sim->visible(address, lcd->type(), r).c_str());
+	printf("lines: %lu, display updates: %lu\n", sink.getLines(), sink.getFlushes());
+    }
+    delete lcd;
+    delete sim;
+    return 0;
+}
@@ -0,0 +1,363 @@
+#ifndef __LCDCORE_H__
+#define __LCDCORE_H__
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <string_view>
+#include <unistd.h>
+#include <linux/i2c.h>
+
+#include <i2cbus.h>
+#include <pca9535.h>
+#include <pots.h>
+#include <i2lcd.h>
+#include <fixedlcd.h>
+
+namespace i2lcd {
+
+#define LCDCORE_OPBYTES	7
+
+/**
+ * @brief Encode one HD44780 operation into PCA9535 message: OUTPUT0
+ * register number, RS set up in separate write before EN rises (only
+ * when it changed), then EN pulse with data on DPORT. OUTPUT0/OUTPUT1
+ * auto-increment makes the whole pulse one message of 5 or 7 bytes.
+ * This is the only HD44780 write encoder, I2Lcd, LcdMirror and BasicLcd
+ * all use it.
+ *
+ * @param p buffer with room for LCDCORE_OPBYTES bytes
+ * @param base CPORT value with RS, RW and EN low
+ * @param rs RS of previous operation, -1 when unknown, updated
+ * @param oprs false for command, true for data
+ * @param value command or data byte
+ * @param cport called with every CPORT value, returns value to write
+ *        (I2Lcd merges potentiometer pulses there)
+ * @return end of encoded message
+ **/
+template <class CPort>
+inline uint8_t *lcdEncode(uint8_t *p, uint8_t base, int &rs, bool oprs, uint8_t value, CPort cport)
+{
+    uint8_t c = base | (oprs ? RS : 0);
+
+    *p++ = OUTPUT0;
+    if (rs != oprs)
+    {
+	*p++ = cport(c);
+	*p++ = value;
+	rs = oprs;
+    }
+    *p++ = cport(c | EN);
+    *p++ = value;
+    *p++ = cport(c);
+    *p++ = value;
+    return p;
+}
+
+inline uint8_t *lcdEncode(uint8_t *p, uint8_t base, int &rs, bool oprs, uint8_t value)
+{
+    return lcdEncode(p, base, rs, oprs, value, [](uint8_t c) { return c; });
+}
+
+/**
+ * @brief HD44780 initialization after power on, shared by I2Lcd and
+ * BasicLcd: function set three times, display off, clear, entry mode
+ * and display on, each followed by time it needs.
+ *
+ * @param lines true for 2-line DDRAM mode
+ * @param command called with every command byte, must send it
+ **/
+template <class Command>
+inline void lcdInit(bool lines, Command command)
+{
+    uint8_t fn = (1 << FUNCTION_SET) | FS_DL | (lines ? FS_N : 0);
+    const uint8_t values[7] = {fn, fn, fn, (1 << DISPLAY_ONOFF), (1 << CLEAR_DISPLAY),
+	(1 << ENTRY_MODE_SET) | EMS_ID, (1 << DISPLAY_ONOFF) | DOO_D};
+    const unsigned us[7] = {5000, 4500, 4500, 6000, 30000, 6000, 6000};
+    unsigned i;
+
+    usleep(4500);
+    for (i = 0; i < 7; i++)
+    {
+	command(values[i]);
+	usleep(us[i]);
+    }
+}
+
+/**
+ * @class RecordBus
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Transport recording messages instead of sending them
+ *
+ * Every written message is appended to the record as address, length
+ * and bytes, reads return zeros. Useful for tests and for measuring
+ * encoding without any bus.
+ *
+ */
+class RecordBus final : public I2CBus
+{
+    private:
+	std::vector<uint8_t> record;
+	unsigned long messages;
+
+    public:
+	RecordBus(uint8_t busn = 0xff) : I2CBus(busn), messages(0) {};
+
+	int transfer(struct i2c_msg *msgs, unsigned count)
+	{
+	    unsigned i;
+
+	    for (i = 0; i < count; i++)
+	    {
+		if (msgs[i].flags & I2C_M_RD)
+		{
+		    std::fill(msgs[i].buf, msgs[i].buf + msgs[i].len, 0);
+		    continue;
+		}
+		record.push_back(msgs[i].addr);
+		record.push_back(msgs[i].len);
+		record.insert(record.end(), msgs[i].buf, msgs[i].buf + msgs[i].len);
+	    }
+	    messages += count;
+	    return count;
+	};
+
+	const std::vector<uint8_t> &getRecord(void) const { return record; };
+	unsigned long getMessages(void) const { return messages; };
+	void clear(void) { record.clear(); messages = 0; };
+};
+
+/**
+ * @brief Transport properties for BasicLcd. Paced transports get every
+ * operation in its own transfer after execution time of the previous
+ * one, others get all operations in one transfer.
+ */
+template <class Transport>
+struct t_TransportTraits {
+    static constexpr bool paced = true;
+};
+
+template <>
+struct t_TransportTraits<RecordBus> {
+    static constexpr bool paced = false;
+};
+
+/**
+ * @class BasicPCA9535
+ *
+ * @ingroup i2lcd
+ *
+ * @brief PCA9535 chip on transport known at compile time
+ *
+ * Same registers as PCA9535, messages go straight to Transport::transfer().
+ * Transports are final classes (I2CDevBus, SimBus, RecordBus), so calls
+ * are bound statically and inlined, there's no virtual dispatch.
+ *
+ */
+template <class Transport>
+class BasicPCA9535
+{
+    private:
+	Transport &iface;
+	uint8_t address;
+
+	void _setRegister(t_PCARegs reg, uint8_t value)
+	{
+	    uint8_t buf[2] = {(uint8_t) reg, value};
+	    struct i2c_msg msg = {address, 0, 2, buf};
+
+	    iface.transfer(&msg, 1);
+	};
+
+	uint8_t _getRegister(t_PCARegs reg) const
+	{
+	    uint8_t r = reg, value = 0;
+	    struct i2c_msg msgs[2] = {{address, 0, 1, &r}, {address, I2C_M_RD, 1, &value}};
+
+	    iface.transfer(msgs, 2);
+	    return value;
+	};
+
+    public:
+	BasicPCA9535(Transport &bus, uint8_t addressn) : iface(bus), address(addressn) {};
+
+	Transport &getInterface() const { return iface; };
+	uint8_t getAddress() const { return address; };
+
+	uint8_t getDirection(t_PCAPort port) const { return _getRegister((t_PCARegs) (CONFIG0 + port)); };
+	void setDirection(t_PCAPort port, uint8_t direction) { _setRegister((t_PCARegs) (CONFIG0 + port), direction); };
+	uint8_t getPort(t_PCAPort port) const { return _getRegister((t_PCARegs) (INPUT0 + port)); };
+	void setOutput(t_PCAPort port, uint8_t value) { _setRegister((t_PCARegs) (OUTPUT0 + port), value); };
+	uint8_t getOutput(t_PCAPort port) const { return _getRegister((t_PCARegs) (OUTPUT0 + port)); };
+	uint8_t getPolarity(t_PCAPort port) const { return _getRegister((t_PCARegs) (POLARITY0 + port)); };
+	void setPolarity(t_PCAPort port, uint8_t value) { _setRegister((t_PCARegs) (POLARITY0 + port), value); };
+
+	/**
+	 * @brief Send prepared messages addressed to this chip
+	 **/
+	int transfer(struct i2c_msg *msgs, unsigned count) { return iface.transfer(msgs, count); };
+};
+
+/**
+ * @class BasicLcd
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Display on transport and geometry known at compile time
+ *
+ * Header only counterpart of I2Lcd for hot paths. Operations are encoded
+ * with lcdEncode() into fixed buffer sized from Geometry, so writing a
+ * character is a few byte stores; flush() sends them. There are no locks,
+ * no virtual calls and no exceptions: one thread owns the object, out of
+ * range positions are refused by put() or don't compile in print<>().
+ *
+ * Potentiometers aren't driven, their CS lines are held high and wipers
+ * stay where I2Lcd or the power-on reset left them. Busy flag isn't read,
+ * paced transports wait execution time of every operation instead.
+ *
+ */
+template <class Transport, class Geometry>
+class BasicLcd
+{
+    private:
+	struct t_Slot {
+	    uint16_t offset;
+	    uint8_t len;
+	    uint16_t us;
+	};
+
+	static constexpr unsigned MAXOPS = Geometry::cells + Geometry::rows + 8;
+
+	BasicPCA9535<Transport> chip;
+	uint8_t base;
+	int rs;
+	unsigned nops;
+	uint8_t *end;
+	uint64_t readyat;
+	t_Slot slots[MAXOPS];
+	uint8_t bytes[MAXOPS * LCDCORE_OPBYTES];
+	struct i2c_msg msgs[MAXOPS];
+
+    public:
+	/**
+	 * @brief Constructor sets port directions, display stays off
+	 *
+	 * @param bus transport
+	 * @param address I2C address of module
+	 **/
+	BasicLcd(Transport &bus, uint8_t address) : chip(bus, address), base(UD | BACKLIGHT_CS | CONTRAST_CS),
+	    rs(-1), nops(0), end(bytes), readyat(0)
+	{
+	    chip.setDirection(CPORT, IRS);
+	    chip.setDirection(DPORT, 0x00);
+	    chip.setOutput(CPORT, base);
+	};
+
+	BasicPCA9535<Transport> &getChip(void) { return chip; };
+	static constexpr uint8_t rows(void) { return Geometry::rows; };
+	static constexpr uint8_t columns(void) { return Geometry::columns; };
+
+	/**
+	 * @brief Switch display power, display is initialized when switched on
+	 **/
+	void power(bool value)
+	{
+	    flush();
+	    base = value ? base | PWR : base & ~PWR;
+	    chip.setOutput(CPORT, base);
+	    rs = -1;
+	    if (!value)
+		return;
+
+	    lcdInit(Geometry::type.getLine(), [this](uint8_t v) {
+		op(false, v);
+		flush();
+	    });
+	};
+
+	/**
+	 * @brief Encode command (rs false) or data byte. Buffer full of
+	 * operations is flushed first.
+	 **/
+	void op(bool oprs, uint8_t value)
+	{
+	    if (nops == MAXOPS)
+		flush();
+	    slots[nops].offset = end - bytes;
+	    slots[nops].us = I2Lcd::execTime(oprs, value);
+	    end = lcdEncode(end, base, rs, oprs, value);
+	    slots[nops].len = end - bytes - slots[nops].offset;
+	    nops++;
+	};
+
+	void command(t_Command command, uint8_t value) { op(false, (1 << (uint8_t) command) | value); };
+	void clear(void) { command(CLEAR_DISPLAY, 0x00); };
+	void setCursor(uint8_t column, uint8_t row) { if (Geometry::contains(column, row)) command(SET_DDRAM_ADDRESS, Geometry::address(column, row)); };
+
+	/**
+	 * @brief Encode text at constant position, cut at the end of the row
+	 **/
+	template <uint8_t C, uint8_t R>
+	void print(std::string_view text)
+	{
+	    constexpr uint8_t address = Geometry::template address<C, R>();
+	    size_t i, len = text.size() < (unsigned) (Geometry::columns - C) ? text.size() : Geometry::columns - C;
+
+	    command(SET_DDRAM_ADDRESS, address);
+	    for (i = 0; i < len; i++)
+		op(true, text[i]);
+	};
+
+	/**
+	 * @brief Encode text at position, cut at the end of the row
+	 *
+	 * @return false when position is outside of the display
+	 **/
+	bool put(uint8_t column, uint8_t row, std::string_view text)
+	{
+	    size_t i, len;
+
+	    if (!Geometry::contains(column, row))
+		return false;
+	    len = text.size() < (unsigned) (Geometry::columns - column) ? text.size() : Geometry::columns - column;
+	    command(SET_DDRAM_ADDRESS, Geometry::address(column, row));
+	    for (i = 0; i < len; i++)
+		op(true, text[i]);
+	    return true;
+	};
+
+	unsigned pending(void) const { return nops; };
+
+	/**
+	 * @brief Send encoded operations. Paced transports get one
+	 * transfer per operation, after the previous one executed.
+	 **/
+	void flush(void)
+	{
+	    unsigned i;
+
+	    for (i = 0; i < nops; i++)
+	    {
+		msgs[i].addr = chip.getAddress();
+		msgs[i].flags = 0;
+		msgs[i].len = slots[i].len;
+		msgs[i].buf = bytes + slots[i].offset;
+		if (t_TransportTraits<Transport>::paced)
+		{
+		    sleepUntil(readyat);
+		    chip.transfer(&msgs[i], 1);
+		    readyat = monotonicNs() + (uint64_t) slots[i].us * 1000;
+		}
+	    }
+	    if (!t_TransportTraits<Transport>::paced && nops)
+		chip.transfer(msgs, nops);
+	    nops = 0;
+	    end = bytes;
+	};
+};
+
+};
+
+#endif
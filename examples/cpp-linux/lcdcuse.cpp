@@ -0,0 +1,259 @@
+#define FUSE_USE_VERSION 31
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cctype>
+#include <vector>
+#include <unistd.h>
+#include <cuse_lowlevel.h>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <shmframe.h>
+#include <lcdcuse.h>
+
+using namespace i2lcd;
+
+/**
+ * lcdcuse - exposes display as character device /dev/i2lcdN through CUSE.
+ *
+ * write() takes text: '\n' moves to the next row, '\r' to column 0,
+ * '\f' clears display and moves home, "\e[<row>;<col>H" moves cursor
+ * (1-based, like VT100), "\e[H" moves home, "\e[2J" clears display and
+ * "\e[K" clears rest of the row. Every open file has its own cursor.
+ *
+ * CUSE devices are not seekable and can't be mapped, so pwrite() and
+ * mmap() aren't available. For random cell access and framebuffer view
+ * I2LCD_GET_INFO returns name of ShmFrame segment holding the content,
+ * clients map it with ShmFrame or shm_open(). Writes of all clients land
+ * in that segment, ShmFlusher is the only thread touching the bus.
+ *
+ * usage: lcdcuse [-b bus] [-a address] [-c columns] [-r rows]
+ *                [-d state directory] [-p refresh ms] [-n device index] [-S]
+ *                [-- CUSE options, like -f for foreground]
+ *
+ * Needs libfuse3 and cuse kernel module, built with "make lcdcuse".
+ */
+
+struct t_Session {
+    uint8_t column;
+    uint8_t row;
+    string escape;
+};
+
+static ShmFrame *shm;
+static I2Lcd *lcd;
+
+/**
+ * @brief Helper clearing rows from given position to the end of row
+ */
+static void _blank(uint8_t column, uint8_t row)
+{
+    string spaces(shm->columns(), ' ');
+
+    shm->put(column, row, spaces.data(), spaces.size());
+}
+
+/**
+ * @brief Helper executing complete escape sequence, without ESC
+ */
+static void _escape(t_Session &s, const string &seq)
+{
+    unsigned r = 1, c = 1;
+    uint8_t i;
+
+    if (seq == "[2J")
+	for (i = 0; i < shm->rows(); i++)
+	    _blank(0, i);
+    else if (seq == "[K")
+	_blank(s.column, s.row);
+    else if (seq == "[H" || sscanf(seq.c_str(), "[%u;%uH", &r, &c) == 2)
+    {
+	s.row = r > 0 && r <= shm->rows() ? r - 1 : 0;
+	s.column = c > 0 && c <= shm->columns() ? c - 1 : 0;
+    }
+}
+
+static void _open(fuse_req_t req, struct fuse_file_info *fi)
+{
+    t_Session *s = new t_Session;
+
+    s->column = s->row = 0;
+    fi->fh = (uint64_t) (uintptr_t) s;
+    fi->direct_io = 1;
+    fuse_reply_open(req, fi);
+}
+
+static void _release(fuse_req_t req, struct fuse_file_info *fi)
+{
+    delete (t_Session *) (uintptr_t) fi->fh;
+    fuse_reply_err(req, 0);
+}
+
+static void _write(fuse_req_t req, const char *buf, size_t size, off_t, struct fuse_file_info *fi)
+{
+    t_Session &s = *(t_Session *) (uintptr_t) fi->fh;
+    size_t i, run;
+    uint8_t r;
+
+    shm->begin();
+    for (i = 0; i < size; )
+    {
+	if (!s.escape.empty())
+	{
+	    s.escape += buf[i++];
+	    if (isalpha((unsigned char) s.escape[s.escape.size() - 1]) || s.escape.size() > 16)
+	    {
+		_escape(s, s.escape.substr(1));
+		s.escape.clear();
+	    }
+	    continue;
+	}
+	switch (buf[i])
+	{
+	    case '\033':
+		s.escape = buf[i++];
+		continue;
+	    case '\n':
+		s.row = (s.row + 1) % shm->rows();
+		s.column = 0;
+		i++;
+		continue;
+	    case '\r':
+		s.column = 0;
+		i++;
+		continue;
+	    case '\f':
+		for (r = 0; r < shm->rows(); r++)
+		    _blank(0, r);
+		s.column = s.row = 0;
+		i++;
+		continue;
+	}
+	for (run = 0; i + run < size && buf[i + run] != '\033' && buf[i + run] != '\n'
+	     && buf[i + run] != '\r' && buf[i + run] != '\f'; run++);
+	if (s.column < shm->columns())
+	    shm->put(s.column, s.row, buf + i, run);
+	s.column = s.column + run < 255 ? s.column + run : 255;
+	i += run;
+    }
+    shm->end();
+    fuse_reply_write(req, size);
+}
+
+static void _ioctl(fuse_req_t req, int cmd, void *, struct fuse_file_info *, unsigned flags,
+		   const void *in, size_t insize, size_t)
+{
+    struct i2lcd_info info;
+    const struct i2lcd_glyph *g;
+
+    if (flags & FUSE_IOCTL_COMPAT)
+    {
+	fuse_reply_err(req, ENOSYS);
+	return;
+    }
+    switch ((unsigned) cmd)
+    {
+	case I2LCD_SET_CONTRAST:
+	case I2LCD_SET_BACKLIGHT:
+	    if (insize < sizeof(int) || *(const int *) in < 0 || *(const int *) in > 0x3f)
+		break;
+	    if ((unsigned) cmd == I2LCD_SET_CONTRAST)
+		lcd->postContrast(*(const int *) in);
+	    else
+		lcd->postBacklight(*(const int *) in);
+	    fuse_reply_ioctl(req, 0, NULL, 0);
+	    return;
+	case I2LCD_SET_GLYPH:
+	    if (insize < sizeof(*g))
+		break;
+	    g = (const struct i2lcd_glyph *) in;
+	    shm->begin();
+	    shm->setGC(g->index, (const char *) g->bitmap);
+	    shm->end();
+	    fuse_reply_ioctl(req, 0, NULL, 0);
+	    return;
+	case I2LCD_GET_INFO:
+	    memset(&info, 0, sizeof(info));
+	    info.columns = shm->columns();
+	    info.rows = shm->rows();
+	    strncpy(info.shm, shm->getName().c_str(), sizeof(info.shm) - 1);
+	    fuse_reply_ioctl(req, 0, &info, sizeof(info));
+	    return;
+    }
+    fuse_reply_err(req, EINVAL);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned bus = 1, address = 0x20, columns = 16, rows = 2, refresh = 20, index = 0;
+    const char *statedir = NULL;
+    bool simulated = false;
+    SimBus *sim = NULL;
+    std::vector<char *> args;
+    char devname[32], shmname[32];
+    const char *devinfo[1] = {devname};
+    struct cuse_info ci;
+    struct cuse_lowlevel_ops ops;
+    int opt, result;
+
+    while ((opt = getopt(argc, argv, "b:a:c:r:d:p:n:S")) != -1)
+	switch (opt)
+	{
+	    case 'b': bus = strtoul(optarg, NULL, 0); break;
+	    case 'a': address = strtoul(optarg, NULL, 0); break;
+	    case 'c': columns = strtoul(optarg, NULL, 0); break;
+	    case 'r': rows = strtoul(optarg, NULL, 0); break;
+	    case 'd': statedir = optarg; break;
+	    case 'p': refresh = strtoul(optarg, NULL, 0); break;
+	    case 'n': index = strtoul(optarg, NULL, 0); break;
+	    case 'S': simulated = true; break;
+	    default:
+		fprintf(stderr, "usage: %s [-b bus] [-a address] [-c columns] [-r rows] [-d statedir] [-p refresh ms] [-n index] [-S] [-- CUSE options]\n", argv[0]);
+		return 1;
+	}
+
+    snprintf(devname, sizeof(devname), "DEVNAME=i2lcd%u", index);
+    snprintf(shmname, sizeof(shmname), "/i2lcd%u", index);
+    args.push_back(argv[0]);
+    for (; optind < argc; optind++)
+	args.push_back(argv[optind]);
+
+    try {
+	if (simulated)
+	{
+	    sim = new SimBus(100000, bus);
+	    lcd = new I2Lcd(*sim, address, columns, rows, statedir);
+	} else
+	    lcd = new I2Lcd(bus, address, columns, rows, statedir);
+	lcd->power(POWERON);
+	lcd->clear();
+	shm = new ShmFrame(shmname, columns, rows);
+    } catch (exception &e) {
+	fprintf(stderr, "%s: can't open display on bus %u address 0x%02x\n", argv[0], bus, address);
+	return 1;
+    }
+
+    memset(&ci, 0, sizeof(ci));
+    ci.dev_info_argc = 1;
+    ci.dev_info_argv = devinfo;
+
+    memset(&ops, 0, sizeof(ops));
+    ops.open = _open;
+    ops.release = _release;
+    ops.write = _write;
+    ops.ioctl = _ioctl;
+
+    {
+	ShmFlusher flusher(*shm, *lcd, refresh);
+
+	result = cuse_lowlevel_main(args.size(), &args[0], &ci, &ops, NULL);
+    }
+
+    delete shm;
+    delete lcd;
+    delete sim;
+    return result;
+}
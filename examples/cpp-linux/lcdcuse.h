@@ -0,0 +1,30 @@
+#ifndef __LCDCUSE_H__
+#define __LCDCUSE_H__
+
+#include <sys/ioctl.h>
+
+/*
+ * ioctl interface of /dev/i2lcdN created by lcdcuse. Plain C, so it
+ * can be included by any client.
+ */
+
+#define I2LCD_IOC_MAGIC		'L'
+
+struct i2lcd_glyph {
+    unsigned char index;
+    unsigned char bitmap[8];
+};
+
+struct i2lcd_info {
+    unsigned char columns;
+    unsigned char rows;
+    char shm[62];
+};
+
+/* levels are 0-63, other values fail with EINVAL */
+#define I2LCD_SET_CONTRAST	_IOW(I2LCD_IOC_MAGIC, 1, int)
+#define I2LCD_SET_BACKLIGHT	_IOW(I2LCD_IOC_MAGIC, 2, int)
+#define I2LCD_SET_GLYPH		_IOW(I2LCD_IOC_MAGIC, 3, struct i2lcd_glyph)
+#define I2LCD_GET_INFO		_IOR(I2LCD_IOC_MAGIC, 4, struct i2lcd_info)
+
+#endif
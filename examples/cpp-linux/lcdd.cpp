@@ -0,0 +1,521 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+#include <lcdd.h>
+#include <simbus.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Helper creating listening Unix socket, stale socket is removed
+ */
+static int _unixSocket(const char *path)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(fd, 16) < 0)
+	throw tDaemonSocket;
+    return fd;
+}
+
+/**
+ * @brief LcdDaemon class constructor. Display must be powered on,
+ * its content is taken over as initial state.
+ *
+ * @param display display owned by the daemon
+ * @param path Unix socket path, stale socket is removed
+ * @param refreshms refresh period in milliseconds
+ **/
+LcdDaemon::LcdDaemon(I2Lcd &display, const char *path, unsigned refreshms) : lcd(display),
+    frame(display.getScreen()), procframe(display.columns(), display.rows()), proc(display.columns(), display.rows()),
+    procshown(false), nextid(1), column(0), row(0), mode(0), dirty(false), moved(false), levels(false), flushes(0)
+{
+    struct itimerspec its;
+
+    _listen(_unixSocket(path), false);
+
+    timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    stopfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (timerfd < 0 || stopfd < 0)
+	throw tDaemonSocket;
+    its.it_interval.tv_sec = refreshms / 1000;
+    its.it_interval.tv_nsec = (refreshms % 1000) * 1000000;
+    its.it_value = its.it_interval;
+    timerfd_settime(timerfd, 0, &its, NULL);
+}
+
+/**
+ * @brief LcdDaemon class destructor. Clients are disconnected,
+ * display keeps its content.
+ **/
+LcdDaemon::~LcdDaemon()
+{
+    size_t i;
+
+    for (i = 0; i < clients.size(); i++)
+	close(clients[i].fd);
+    for (i = 0; i < listeners.size(); i++)
+	close(listeners[i].fd);
+    close(timerfd);
+    close(stopfd);
+}
+
+/**
+ * @brief Make run() return. Can be called from any thread
+ * or signal handler.
+ **/
+void LcdDaemon::stop(void)
+{
+    uint64_t v = 1;
+
+    if (::write(stopfd, &v, sizeof(v)) < 0) {};
+}
+
+/**
+ * @brief Helper adding listening socket. This method is private
+ **/
+void LcdDaemon::_listen(int fd, bool lcdproc)
+{
+    t_Listener l;
+
+    l.fd = fd;
+    l.lcdproc = lcdproc;
+    listeners.push_back(l);
+}
+
+/**
+ * @brief Accept LCDproc clients on local TCP port
+ *
+ * @param port TCP port on 127.0.0.1, LCDPROC_PORT is the usual one
+ **/
+void LcdDaemon::listenLcdproc(uint16_t port)
+{
+    struct sockaddr_in addr;
+    int fd, on = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+	throw tDaemonSocket;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(fd, 16) < 0)
+    {
+	close(fd);
+	throw tDaemonSocket;
+    }
+    _listen(fd, true);
+}
+
+/**
+ * @brief Accept LCDproc clients on Unix socket
+ *
+ * @param path socket path, stale socket is removed
+ **/
+void LcdDaemon::listenLcdproc(const char *path)
+{
+    _listen(_unixSocket(path), true);
+}
+
+/**
+ * @brief Accept waiting connections
+ **/
+void LcdDaemon::_accept(const t_Listener &listener)
+{
+    t_Client client;
+    int fd;
+
+    while ((fd = accept4(listener.fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+	if (clients.size() >= LCDD_MAX_CLIENTS)
+	{
+	    close(fd);
+	    continue;
+	}
+	client.fd = fd;
+	client.id = nextid++;
+	client.lcdproc = listener.lcdproc;
+	client.sync = false;
+	clients.push_back(client);
+    }
+}
+
+/**
+ * @brief Read and execute complete command lines of client
+ *
+ * @return false when client should be dropped
+ **/
+bool LcdDaemon::_read(t_Client &client)
+{
+    char buf[512];
+    ssize_t n;
+
+    while ((n = ::read(client.fd, buf, sizeof(buf))) > 0)
+    {
+	client.in.append(buf, n);
+	_lines(client);
+	if (client.in.size() > (client.sync ? LCDD_MAX_OUTPUT : LCDD_MAX_LINE))
+	    return false;
+    }
+    return n < 0 && (errno == EAGAIN || errno == EINTR);
+}
+
+/**
+ * @brief Execute complete lines in client's input. Client waiting
+ * for sync has its following lines held until refresh.
+ **/
+void LcdDaemon::_lines(t_Client &client)
+{
+    size_t pos;
+
+    while (!client.sync && (pos = client.in.find('\n')) != string::npos)
+    {
+	if (client.lcdproc)
+	    proc.command(client.id, client.in.substr(0, pos), client.out);
+	else
+	    _command(client, client.in.substr(0, pos));
+	client.in.erase(0, pos + 1);
+    }
+}
+
+/**
+ * @brief Send pending answers to client
+ *
+ * @return false when client should be dropped
+ **/
+bool LcdDaemon::_write(t_Client &client)
+{
+    ssize_t n;
+
+    while (!client.out.empty())
+    {
+	n = send(client.fd, client.out.data(), client.out.size(), MSG_NOSIGNAL);
+	if (n < 0)
+	    return (errno == EAGAIN || errno == EINTR) && client.out.size() < LCDD_MAX_OUTPUT;
+	client.out.erase(0, n);
+    }
+    return true;
+}
+
+/**
+ * @brief Execute one command line. Only in-memory state changes,
+ * display is updated by next refresh.
+ **/
+void LcdDaemon::_command(t_Client &client, const string &line)
+{
+    const char *s = line.c_str();
+    unsigned a, b, v[8];
+    char word[16], glyph[8];
+    int n = 0, i;
+
+    if (!line.empty() && line[line.size() - 1] == '\r')
+	return _command(client, line.substr(0, line.size() - 1));
+    if (sscanf(s, "%15s %n", word, &n) != 1)
+	return;
+    s += n;
+
+    if (!strcmp(word, "text"))
+    {
+	if (sscanf(s, "%u %u %n", &a, &b, &n) < 2 || a >= frame.columns() || b >= frame.rows())
+	{
+	    client.out += "error position\n";
+	    return;
+	}
+	frame.print(a, b, string(s + n));
+	dirty = true;
+    } else if (!strcmp(word, "clear"))
+    {
+	frame.clear();
+	dirty = true;
+    } else if (!strcmp(word, "cursor"))
+    {
+	word[0] = 0;
+	if (sscanf(s, "%u %u %15s", &a, &b, word) < 2 || a >= frame.columns() || b >= frame.rows())
+	{
+	    client.out += "error position\n";
+	    return;
+	}
+	column = a;
+	row = b;
+	if (!strcmp(word, "on"))
+	    mode = 1;
+	else if (!strcmp(word, "blink"))
+	    mode = 2;
+	else if (!strcmp(word, "off"))
+	    mode = 0;
+	moved = true;
+    } else if (!strcmp(word, "glyph"))
+    {
+	if (sscanf(s, "%u %x %x %x %x %x %x %x %x", &a, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7]) != 9 || a > 7)
+	{
+	    client.out += "error glyph\n";
+	    return;
+	}
+	for (i = 0; i < 8; i++)
+	    glyph[i] = v[i] & 0x1f;
+	frame.setGC(a, glyph);
+	dirty = true;
+    } else if (!strcmp(word, "backlight") && sscanf(s, "%u", &a) == 1)
+    {
+	if (a > 0x3f)
+	{
+	    client.out += "error level\n";
+	    return;
+	}
+	lcd.postBacklight(a);
+	levels = true;
+    } else if (!strcmp(word, "contrast") && sscanf(s, "%u", &a) == 1)
+    {
+	if (a > 0x3f)
+	{
+	    client.out += "error level\n";
+	    return;
+	}
+	lcd.postContrast(a);
+	levels = true;
+    } else if (!strcmp(word, "levels") && sscanf(s, "%u %u", &a, &b) == 2)
+    {
+	if (a > 0x3f || b > 0x3f)
+	{
+	    client.out += "error level\n";
+	    return;
+	}
+	lcd.postLevels(a, b);
+	levels = true;
+    } else if (!strcmp(word, "get"))
+    {
+	if (sscanf(s, "%u", &a) != 1 || a >= frame.rows())
+	{
+	    client.out += "error row\n";
+	    return;
+	}
+	client.out += "row " + frame.text(a) + "\n";
+	return;
+    } else if (!strcmp(word, "sync"))
+    {
+	client.sync = true;
+	return;
+    } else
+    {
+	client.out += "error command\n";
+	return;
+    }
+    client.out += "ok\n";
+}
+
+/**
+ * @brief Send everything changed since last refresh to display
+ **/
+void LcdDaemon::_flush(void)
+{
+    std::vector<std::pair<unsigned, string> > &notices = proc.getNotices();
+    size_t i, j;
+
+    if (proc.render(monotonicMs(), procframe))
+    {
+	if (!procshown)
+	{
+	    lcd.cursor(false);
+	    lcd.blink(false);
+	}
+	lcd.show(procframe);
+	procshown = true;
+    } else if (dirty || procshown)
+    {
+	lcd.show(frame);
+	moved = moved || procshown;
+	procshown = false;
+    }
+    for (i = 0; i < notices.size(); i++)
+	for (j = 0; j < clients.size(); j++)
+	    if (clients[j].id == notices[i].first)
+		clients[j].out += notices[i].second;
+    notices.clear();
+
+    if (moved && !procshown)
+    {
+	lcd.setCursor(column, row);
+	lcd.cursor(mode != 0);
+	lcd.blink(mode == 2);
+    }
+    if (levels || dirty || moved)
+	lcd.flushLevels();
+    if (dirty || moved || levels)
+	flushes++;
+    dirty = moved = levels = false;
+
+    for (i = 0; i < clients.size(); i++)
+	if (clients[i].sync)
+	{
+	    clients[i].out += "ok\n";
+	    clients[i].sync = false;
+	    _lines(clients[i]);
+	}
+}
+
+/**
+ * @brief Serve clients until stop() is called
+ **/
+void LcdDaemon::run(void)
+{
+    std::vector<struct pollfd> fds;
+    uint64_t v;
+    size_t i, c;
+
+    for (;;)
+    {
+	fds.resize(2 + listeners.size() + clients.size());
+	fds[0].fd = stopfd;
+	fds[1].fd = timerfd;
+	for (i = 0; i < listeners.size(); i++)
+	    fds[2 + i].fd = listeners[i].fd;
+	for (i = 0; i < 2 + listeners.size(); i++)
+	    fds[i].events = POLLIN;
+	c = 2 + listeners.size();
+	for (i = 0; i < clients.size(); i++)
+	{
+	    fds[c + i].fd = clients[i].fd;
+	    fds[c + i].events = POLLIN | (clients[i].out.empty() ? 0 : POLLOUT);
+	}
+
+	if (poll(&fds[0], fds.size(), -1) < 0)
+	{
+	    if (errno == EINTR)
+		continue;
+	    break;
+	}
+	if (fds[0].revents)
+	    break;
+	if (fds[1].revents)
+	{
+	    if (::read(timerfd, &v, sizeof(v)) < 0) {};
+	    _flush();
+	}
+
+	for (i = clients.size(); i-- > 0; )
+	{
+	    bool keep = true;
+
+	    if (fds[c + i].revents & (POLLIN | POLLHUP | POLLERR))
+		keep = _read(clients[i]);
+	    if (keep)
+		keep = _write(clients[i]);
+	    if (!keep)
+	    {
+		if (clients[i].lcdproc)
+		    proc.disconnect(clients[i].id);
+		close(clients[i].fd);
+		clients.erase(clients.begin() + i);
+	    }
+	}
+	for (i = 0; i < listeners.size(); i++)
+	    if (fds[2 + i].revents)
+		_accept(listeners[i]);
+    }
+    _flush();
+}
+
+static LcdDaemon *daemon_ptr;
+
+static void _signal(int)
+{
+    if (daemon_ptr)
+	daemon_ptr->stop();
+}
+
+/**
+ * lcdd - display daemon. Owns one I2LCD module and serves clients over
+ * Unix socket, see LcdDaemon for the protocol.
+ *
+ * usage: lcdd [-b bus] [-a address] [-c columns] [-r rows] [-s socket]
+ *             [-d state directory] [-p refresh ms] [-l LCDproc port]
+ *             [-L LCDproc socket] [-S]
+ *
+ * -l and -L accept LCDproc clients, usual port is 13666.
+ *
+ * -S runs on simulated bus, for trying clients without hardware.
+ */
+int main(int argc, char **argv)
+{
+    unsigned bus = 1, address = 0x20, columns = 16, rows = 2, refresh = LCDD_REFRESH_MS;
+    const char *path = LCDD_SOCKET, *statedir = NULL, *procpath = NULL;
+    unsigned procport = 0;
+    bool simulated = false;
+    SimBus *sim = NULL;
+    I2Lcd *lcd;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:a:c:r:s:d:p:l:L:S")) != -1)
+	switch (opt)
+	{
+	    case 'b': bus = strtoul(optarg, NULL, 0); break;
+	    case 'a': address = strtoul(optarg, NULL, 0); break;
+	    case 'c': columns = strtoul(optarg, NULL, 0); break;
+	    case 'r': rows = strtoul(optarg, NULL, 0); break;
+	    case 's': path = optarg; break;
+	    case 'd': statedir = optarg; break;
+	    case 'p': refresh = strtoul(optarg, NULL, 0); break;
+	    case 'l': procport = strtoul(optarg, NULL, 0); break;
+	    case 'L': procpath = optarg; break;
+	    case 'S': simulated = true; break;
+	    default:
+		fprintf(stderr, "usage: %s [-b bus] [-a address] [-c columns] [-r rows] [-s socket] [-d statedir] [-p refresh ms] [-l LCDproc port] [-L LCDproc socket] [-S]\n", argv[0]);
+		return 1;
+	}
+
+    try {
+	if (simulated)
+	{
+	    sim = new SimBus(100000, bus);
+	    lcd = new I2Lcd(*sim, address, columns, rows, statedir);
+	} else
+	    lcd = new I2Lcd(bus, address, columns, rows, statedir);
+	lcd->power(POWERON);
+	lcd->clear();
+
+	LcdDaemon lcdd(*lcd, path, refresh ? refresh : 1);
+
+	if (procport)
+	    lcdd.listenLcdproc((uint16_t) procport);
+	if (procpath)
+	    lcdd.listenLcdproc(procpath);
+
+	daemon_ptr = &lcdd;
+	signal(SIGINT, _signal);
+	signal(SIGTERM, _signal);
+	lcdd.run();
+	daemon_ptr = NULL;
+	unlink(path);
+	if (procpath)
+	    unlink(procpath);
+    } catch (exception &e) {
+	fprintf(stderr, "%s: can't start on bus %u address 0x%02x\n", argv[0], bus, address);
+	return 1;
+    }
+
+    delete lcd;
+    delete sim;
+    return 0;
+}
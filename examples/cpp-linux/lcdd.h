@@ -0,0 +1,122 @@
+#ifndef __LCDD_H__
+#define __LCDD_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <i2lcd.h>
+#include <framebuffer.h>
+#include <lcdproc.h>
+
+namespace i2lcd {
+
+#define LCDD_SOCKET	"/run/lcdd.sock"
+#define LCDD_REFRESH_MS	20
+#define LCDD_MAX_CLIENTS	64
+#define LCDD_MAX_LINE	1024
+#define LCDD_MAX_OUTPUT	65536
+
+/**
+ * @class DaemonSocket
+ *
+ * @ingroup i2lcd
+ *
+ * @brief DaemonSocket Exception class thrown when daemon can't create
+ *        its socket or timer
+ *
+ *
+ */
+class DaemonSocket: public exception
+{
+} tDaemonSocket;
+
+/**
+ * @class LcdDaemon
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Display daemon owning I2Lcd and serving clients over Unix socket.
+ *
+ * Clients never touch the bus. Commands only change in-memory copy of
+ * the display and are answered at once, the copy is sent to display by
+ * refresh timer, so writes of all clients between two ticks go out as
+ * one diffed batch. Connecting costs accept() only, display is
+ * initialized once when daemon starts.
+ *
+ * Protocol is line based, every command is answered with "ok" or
+ * "error <reason>" line:
+ *
+ *   text <column> <row> <text>     put text, wraps to following rows
+ *   clear                          fill with spaces
+ *   cursor <column> <row> [off|on|blink]
+ *   glyph <0-7> <8 hex bytes>      define user character
+ *   backlight <0-63>
+ *   contrast <0-63>
+ *   levels <backlight> <contrast>
+ *   get <row>                      answer "row <text>" from memory
+ *   sync                           answer after next refresh, following
+ *                                  commands wait for it
+ *
+ * Daemon can also listen for LCDproc clients (see LcdprocServer). While
+ * any LCDproc screen is visible it is shown instead of the native frame.
+ *
+ */
+class LcdDaemon
+{
+    private:
+	struct t_Client {
+	    int fd;
+	    unsigned id;
+	    bool lcdproc;
+	    string in;
+	    string out;
+	    bool sync;
+	};
+
+	struct t_Listener {
+	    int fd;
+	    bool lcdproc;
+	};
+
+	I2Lcd &lcd;
+	FrameBuffer frame;
+	FrameBuffer procframe;
+	LcdprocServer proc;
+	bool procshown;
+	unsigned nextid;
+	uint8_t column;
+	uint8_t row;
+	uint8_t mode;
+	bool dirty;
+	bool moved;
+	int timerfd;
+	int stopfd;
+	std::vector<t_Listener> listeners;
+	std::vector<t_Client> clients;
+	bool levels;
+	unsigned long flushes;
+
+	void _listen(int fd, bool lcdproc);
+	void _accept(const t_Listener &listener);
+	bool _read(t_Client &client);
+	void _lines(t_Client &client);
+	bool _write(t_Client &client);
+	void _command(t_Client &client, const string &line);
+	void _flush(void);
+
+    public:
+	LcdDaemon(I2Lcd &display, const char *path, unsigned refreshms = LCDD_REFRESH_MS);
+	~LcdDaemon();
+
+	void listenLcdproc(uint16_t port);
+	void listenLcdproc(const char *path);
+	void run(void);
+	void stop(void);
+
+	unsigned long getFlushes(void) const { return flushes; };
+};
+
+};
+
+#endif
@@ -0,0 +1,35 @@
+#include <iostream>
+#include <i2lcd.h>
+#include <fader.h>
+
+#include <unistd.h>
+
+using namespace i2lcd;
+
+int main(void)
+{
+    int i;
+
+    I2Lcd lcd(2, 0x20, 16, 2, "/run");
+
+    lcd.power(POWERON);
+    lcd.setContrast(0x17);
+    lcd.clear();
+
+    Fader fader(lcd);
+
+    for (i = 0; i < 4; i++)
+    {
+	fader.fadeBacklight(i & 1 ? 0x00 : 0x3f, 2000);
+	while (fader.busy())
+	{
+	    lcd.setCursor(0, 0);
+	    lcd.print("Backlight " + to_string(lcd.getBacklight()) + "  ");
+	    usleep(20000);
+	}
+    }
+
+    fader.fade(0x3f, 0x17, 500);
+    fader.wait();
+    lcd.power(POWEROFF);
+}
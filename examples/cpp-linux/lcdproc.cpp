@@ -0,0 +1,507 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <lcdproc.h>
+
+using namespace i2lcd;
+
+#define SHAPE_HBAR	0x10
+#define SHAPE_VBAR	0x20
+#define CHAR_FULL	((char) 0xff)
+
+/**
+ * @brief LcdprocServer class constructor
+ *
+ * @param columns display width
+ * @param rows display height
+ **/
+LcdprocServer::LcdprocServer(uint8_t columns, uint8_t rows) : cols(columns), nrows(rows), active(-1), shownat(0)
+{
+    memset(shapes, 0, sizeof(shapes));
+}
+
+/**
+ * @brief Helper splitting command into arguments. Arguments may be
+ * quoted with "" or {}, backslash escapes next character.
+ *
+ * @return false on unterminated quote
+ **/
+bool LcdprocServer::_split(const string &line, std::vector<string> &args)
+{
+    size_t i = 0, n = line.size();
+    string arg;
+    char close;
+
+    args.clear();
+    for (;;)
+    {
+	while (i < n && (line[i] == ' ' || line[i] == '\t'))
+	    i++;
+	if (i >= n)
+	    return true;
+
+	arg.clear();
+	close = 0;
+	if (line[i] == '"')
+	    close = '"';
+	else if (line[i] == '{')
+	    close = '}';
+	if (close)
+	{
+	    for (i++; i < n && line[i] != close; i++)
+	    {
+		if (line[i] == '\\' && i + 1 < n)
+		    i++;
+		arg += line[i];
+	    }
+	    if (i++ >= n)
+		return false;
+	} else
+	    for (; i < n && line[i] != ' ' && line[i] != '\t'; i++)
+		arg += line[i];
+	args.push_back(arg);
+    }
+}
+
+/**
+ * @brief Helper converting priority name or number to class
+ **/
+int LcdprocServer::_priority(const string &value)
+{
+    static const char *names[] = {"hidden", "background", "info", "foreground", "alert", "input"};
+    unsigned i;
+    int n;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+	if (value == names[i])
+	    return i;
+    n = atoi(value.c_str());
+    if (n <= 0)
+	return PROC_INFO;
+    return n <= 64 ? PROC_FOREGROUND : (n <= 192 ? PROC_INFO : PROC_BACKGROUND);
+}
+
+/**
+ * @brief Helper finding client's screen, NULL if there's none
+ **/
+LcdprocServer::t_Screen *LcdprocServer::_screen(unsigned client, const string &id)
+{
+    size_t i;
+
+    for (i = 0; i < screens.size(); i++)
+	if (screens[i].client == client && screens[i].id == id)
+	    return &screens[i];
+    return NULL;
+}
+
+/**
+ * @brief Helper finding widget of a screen, NULL if there's none
+ **/
+LcdprocServer::t_Widget *LcdprocServer::_widget(t_Screen *screen, const string &id)
+{
+    size_t i;
+
+    for (i = 0; i < screen->widgets.size(); i++)
+	if (screen->widgets[i].id == id)
+	    return &screen->widgets[i];
+    return NULL;
+}
+
+/**
+ * @brief Execute one command of LCDproc client
+ *
+ * @param client client identifier
+ * @param line command without line end
+ * @param answer string answer is appended to
+ **/
+void LcdprocServer::command(unsigned client, const string &line, string &answer)
+{
+    std::vector<string> a;
+    t_Screen *s = NULL;
+    t_Widget *w = NULL, nw;
+    t_Screen ns;
+    char buf[128];
+    size_t i;
+    int max;
+
+    if (!_split(line, a))
+    {
+	answer += "huh? Unterminated string\n";
+	return;
+    }
+    if (a.empty())
+	return;
+
+    if (a[0] == "hello")
+    {
+	snprintf(buf, sizeof(buf), "connect LCDproc 0.5.9 protocol 0.3 lcd wid %u hgt %u cellwid %u cellhgt %u\n",
+	    cols, nrows, LCDPROC_CELLWID, LCDPROC_CELLHGT);
+	answer += buf;
+	return;
+    }
+    if (a[0] == "client_set" || a[0] == "noop" || a[0] == "backlight" || a[0] == "output"
+	|| a[0] == "client_add_key" || a[0] == "client_del_key")
+    {
+	answer += "success\n";
+	return;
+    }
+    if (a[0] == "info")
+    {
+	answer += "I2LCD HD44780 on PCA9535\n";
+	return;
+    }
+    if (a[0].compare(0, 7, "screen_") && a[0].compare(0, 7, "widget_"))
+    {
+	answer += "huh? Invalid command \"" + a[0] + "\"\n";
+	return;
+    }
+    if (a.size() < 2)
+    {
+	answer += "huh? Not enough arguments\n";
+	return;
+    }
+
+    if (a[0] == "screen_add")
+    {
+	if (_screen(client, a[1]))
+	{
+	    answer += "huh? Screen already exists\n";
+	    return;
+	}
+	ns.client = client;
+	ns.id = a[1];
+	ns.priority = PROC_INFO;
+	ns.duration = LCDPROC_DURATION;
+	screens.push_back(ns);
+	answer += "success\n";
+	return;
+    }
+
+    s = _screen(client, a[1]);
+    if (!s)
+    {
+	answer += "huh? Unknown screen id\n";
+	return;
+    }
+
+    if (a[0] == "screen_del")
+    {
+	i = s - &screens[0];
+	if ((int) i == active)
+	    active = -1;
+	else if ((int) i < active)
+	    active--;
+	screens.erase(screens.begin() + i);
+	answer += "success\n";
+    } else if (a[0] == "screen_set")
+    {
+	for (i = 2; i + 1 < a.size(); i += 2)
+	    if (a[i] == "-priority")
+		s->priority = _priority(a[i + 1]);
+	    else if (a[i] == "-duration")
+		s->duration = atoi(a[i + 1].c_str()) > 0 ? atoi(a[i + 1].c_str()) : LCDPROC_DURATION;
+	answer += "success\n";
+    } else if (a[0] == "widget_add")
+    {
+	if (a.size() < 4 || _widget(s, a[2]))
+	{
+	    answer += "huh? Invalid widget\n";
+	    return;
+	}
+	if (a[3] == "frame")
+	{
+	    answer += "huh? Frame widgets aren't supported\n";
+	    return;
+	}
+	nw.id = a[2];
+	nw.type = a[3];
+	nw.x = nw.y = nw.right = nw.bottom = nw.length = nw.speed = 0;
+	nw.direction = 'h';
+	s->widgets.push_back(nw);
+	answer += "success\n";
+    } else if (a[0] == "widget_del")
+    {
+	if (a.size() < 3 || !(w = _widget(s, a[2])))
+	{
+	    answer += "huh? Unknown widget id\n";
+	    return;
+	}
+	s->widgets.erase(s->widgets.begin() + (w - &s->widgets[0]));
+	answer += "success\n";
+    } else if (a[0] == "widget_set")
+    {
+	if (a.size() < 3 || !(w = _widget(s, a[2])))
+	{
+	    answer += "huh? Unknown widget id\n";
+	    return;
+	}
+	if (w->type == "title" && a.size() >= 4)
+	    w->text = a[3];
+	else if ((w->type == "string" || w->type == "icon") && a.size() >= 6)
+	{
+	    if (!_inside(atoi(a[3].c_str()), atoi(a[4].c_str())))
+	    {
+		answer += "huh? Invalid coordinates\n";
+		return;
+	    }
+	    w->x = atoi(a[3].c_str());
+	    w->y = atoi(a[4].c_str());
+	    w->text = a[5];
+	} else if ((w->type == "hbar" || w->type == "vbar") && a.size() >= 6)
+	{
+	    if (!_inside(atoi(a[3].c_str()), atoi(a[4].c_str())))
+	    {
+		answer += "huh? Invalid coordinates\n";
+		return;
+	    }
+	    w->x = atoi(a[3].c_str());
+	    w->y = atoi(a[4].c_str());
+	    /* longer bar than the display is clipped by frame, but mustn't loop for ages */
+	    max = w->type == "hbar" ? cols * LCDPROC_CELLWID : nrows * LCDPROC_CELLHGT;
+	    w->length = atoi(a[5].c_str());
+	    w->length = w->length < 0 ? 0 : (w->length > max ? max : w->length);
+	} else if (w->type == "num" && a.size() >= 5)
+	{
+	    if (!_inside(atoi(a[3].c_str()), 1) || atoi(a[4].c_str()) < 0 || atoi(a[4].c_str()) > 10)
+	    {
+		answer += "huh? Invalid coordinates\n";
+		return;
+	    }
+	    w->x = atoi(a[3].c_str());
+	    w->length = atoi(a[4].c_str());
+	} else if (w->type == "scroller" && a.size() >= 10)
+	{
+	    if (!_inside(atoi(a[3].c_str()), atoi(a[4].c_str())) || !_inside(atoi(a[5].c_str()), atoi(a[6].c_str())))
+	    {
+		answer += "huh? Invalid coordinates\n";
+		return;
+	    }
+	    w->x = atoi(a[3].c_str());
+	    w->y = atoi(a[4].c_str());
+	    w->right = atoi(a[5].c_str());
+	    w->bottom = atoi(a[6].c_str());
+	    w->direction = a[7].empty() ? 'h' : a[7][0];
+	    w->speed = atoi(a[8].c_str());
+	    w->text = a[9];
+	} else
+	{
+	    answer += "huh? Wrong number of arguments\n";
+	    return;
+	}
+	answer += "success\n";
+    } else
+	answer += "huh? Invalid command \"" + a[0] + "\"\n";
+}
+
+/**
+ * @brief Helper checking 1-based LCDproc position is on the display.
+ * This method is private
+ **/
+bool LcdprocServer::_inside(int x, int y) const
+{
+    return x >= 1 && x <= cols && y >= 1 && y <= nrows;
+}
+
+/**
+ * @brief Drop all screens of disconnected client
+ *
+ * @param client client identifier
+ **/
+void LcdprocServer::disconnect(unsigned client)
+{
+    size_t i;
+
+    for (i = screens.size(); i-- > 0; )
+	if (screens[i].client == client)
+	{
+	    if ((int) i == active)
+		active = -1;
+	    else if ((int) i < active)
+		active--;
+	    screens.erase(screens.begin() + i);
+	}
+}
+
+/**
+ * @brief Helper switching visible screen and queueing notices.
+ * This method is private
+ **/
+void LcdprocServer::_show(int index, uint64_t ms)
+{
+    if (index == active)
+	return;
+    if (active >= 0)
+	notices.push_back(std::make_pair(screens[active].client, "ignore " + screens[active].id + "\n"));
+    if (index >= 0)
+	notices.push_back(std::make_pair(screens[index].client, "listen " + screens[index].id + "\n"));
+    active = index;
+    shownat = ms;
+}
+
+/**
+ * @brief Helper returning CGRAM slot holding shape, -1 if none
+ **/
+int LcdprocServer::_slot(uint8_t shape) const
+{
+    int i;
+
+    for (i = 0; i < 8; i++)
+	if (shapes[i] == shape)
+	    return i;
+    return -1;
+}
+
+/**
+ * @brief Helper allocating CGRAM slots for partial bar cells of the screen.
+ * Shapes still needed keep their slots, so CGRAM isn't rewritten while
+ * bars move. Shapes which don't fit are drawn rounded down.
+ **/
+void LcdprocServer::_glyphs(const t_Screen &screen, FrameBuffer &frame)
+{
+    bool needed[0x30];
+    char bitmap[8];
+    uint8_t shape;
+    size_t i;
+    int j, k;
+
+    memset(needed, 0, sizeof(needed));
+    for (i = 0; i < screen.widgets.size(); i++)
+    {
+	const t_Widget &w = screen.widgets[i];
+
+	if (w.type == "hbar" && w.length % LCDPROC_CELLWID)
+	    needed[SHAPE_HBAR | (w.length % LCDPROC_CELLWID)] = true;
+	else if (w.type == "vbar" && w.length % LCDPROC_CELLHGT)
+	    needed[SHAPE_VBAR | (w.length % LCDPROC_CELLHGT)] = true;
+    }
+
+    for (j = 0; j < 8; j++)
+	if (shapes[j] && !needed[shapes[j]])
+	    shapes[j] = 0;
+    for (shape = 0; shape < sizeof(needed); shape++)
+	if (needed[shape] && _slot(shape) < 0 && (j = _slot(0)) >= 0)
+	{
+	    shapes[j] = shape;
+	    for (k = 0; k < 8; k++)
+		if (shape & SHAPE_HBAR)
+		    bitmap[k] = 0x1f & ~(0x1f >> (shape & 0x0f));
+		else
+		    bitmap[k] = k >= 8 - (shape & 0x0f) ? 0x1f : 0x00;
+	    frame.setGC(j, bitmap);
+	}
+}
+
+/**
+ * @brief Helper drawing one widget. This method is private
+ **/
+void LcdprocServer::_draw(const t_Widget &w, uint64_t ms, FrameBuffer &frame)
+{
+    int x = w.x - 1, y = w.y - 1, n, i, width, height, steps, offset;
+    string text;
+
+    if (w.type == "title")
+    {
+	text = w.text.substr(0, cols);
+	frame.put(0, 0, text.data(), text.size());
+	for (i = text.size() + 1; i < cols; i++)
+	    frame.put(i, 0, CHAR_FULL);
+    } else if (w.type == "string")
+	frame.put(x, y, w.text.data(), w.text.size());
+    else if (w.type == "icon")
+    {
+	if (w.text == "ARROW_RIGHT")
+	    frame.put(x, y, (char) 0x7e);
+	else if (w.text == "ARROW_LEFT")
+	    frame.put(x, y, (char) 0x7f);
+	else if (w.text == "BLOCK_FILLED")
+	    frame.put(x, y, CHAR_FULL);
+	else
+	    frame.put(x, y, '*');
+    } else if (w.type == "hbar")
+    {
+	for (i = 0; i < w.length / LCDPROC_CELLWID && x + i < cols; i++)
+	    frame.put(x + i, y, CHAR_FULL);
+	if ((n = _slot(SHAPE_HBAR | (w.length % LCDPROC_CELLWID))) >= 0)
+	    frame.put(x + i, y, (char) n);
+    } else if (w.type == "vbar")
+    {
+	for (i = 0; i < w.length / LCDPROC_CELLHGT && y - i >= 0; i++)
+	    frame.put(x, y - i, CHAR_FULL);
+	if (y - i >= 0 && (n = _slot(SHAPE_VBAR | (w.length % LCDPROC_CELLHGT))) >= 0)
+	    frame.put(x, y - i, (char) n);
+    } else if (w.type == "num")
+	frame.put(x, 0, w.length == 10 ? ':' : (char) ('0' + w.length % 10));
+    else if (w.type == "scroller")
+    {
+	width = w.right - w.x + 1;
+	height = w.bottom - w.y + 1;
+	if (width <= 0 || height <= 0)
+	    return;
+	steps = w.speed > 0 ? ms / 125 / w.speed : (w.speed < 0 ? ms / 125 * -w.speed : 0);
+	n = w.text.size();
+
+	if (w.direction == 'v')
+	{
+	    offset = n > width * height ? steps % ((n + width - 1) / width - height + 1) : 0;
+	    for (i = 0; i < height; i++)
+		if ((offset + i) * width < n)
+		{
+		    text = w.text.substr((offset + i) * width, width);
+		    frame.put(x, y + i, text.data(), text.size());
+		}
+	} else if (n <= width)
+	    frame.put(x, y, w.text.data(), n);
+	else if (w.direction == 'm')
+	{
+	    text = w.text + " ";
+	    offset = steps % text.size();
+	    text = text.substr(offset) + text.substr(0, offset);
+	    frame.put(x, y, text.data(), width);
+	} else
+	{
+	    text = w.text.substr(steps % (n - width + 1), width);
+	    frame.put(x, y, text.data(), text.size());
+	}
+    }
+}
+
+/**
+ * @brief Render visible screen. Screen of highest priority class is
+ * shown, screens of the same class rotate after their duration.
+ *
+ * @param ms monotonic time in milliseconds
+ * @param frame frame to draw into, keeps its glyphs between renders
+ * @return false if there's no screen to show
+ **/
+bool LcdprocServer::render(uint64_t ms, FrameBuffer &frame)
+{
+    int best = PROC_HIDDEN, next = -1;
+    size_t i, n = screens.size();
+
+    for (i = 0; i < n; i++)
+	if (screens[i].priority > best)
+	    best = screens[i].priority;
+
+    if (best == PROC_HIDDEN)
+	_show(-1, ms);
+    else if (active < 0 || screens[active].priority != best
+	     || ms - shownat >= (uint64_t) screens[active].duration * 125)
+    {
+	for (i = 1; i <= n; i++)
+	{
+	    next = (active + i + n) % n;
+	    if (screens[next].priority == best)
+		break;
+	}
+	_show(next, ms);
+    }
+    if (active < 0)
+	return false;
+
+    frame.clear();
+    _glyphs(screens[active], frame);
+    for (i = 0; i < screens[active].widgets.size(); i++)
+	_draw(screens[active].widgets[i], ms - shownat, frame);
+    return true;
+}
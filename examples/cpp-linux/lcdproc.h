@@ -0,0 +1,100 @@
+#ifndef __LCDPROC_H__
+#define __LCDPROC_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+#define LCDPROC_PORT		13666
+#define LCDPROC_DURATION	32
+#define LCDPROC_CELLWID		5
+#define LCDPROC_CELLHGT		8
+
+/**
+ * @brief LCDproc screen priority classes, higher is shown first
+ */
+enum t_ProcPriority {
+    PROC_HIDDEN,
+    PROC_BACKGROUND,
+    PROC_INFO,
+    PROC_FOREGROUND,
+    PROC_ALERT,
+    PROC_INPUT,
+};
+
+/**
+ * @class LcdprocServer
+ *
+ * @ingroup i2lcd
+ *
+ * @brief LCDproc client protocol (0.3) on top of FrameBuffer.
+ *
+ * Keeps screens and widgets of LCDproc clients and renders visible
+ * screen into a frame, which the caller shows with I2Lcd::show(), so
+ * only cells changed since previous render reach the display. Screens
+ * of the highest priority class rotate after their duration, owners
+ * get "listen" and "ignore" notices.
+ *
+ * Widgets are drawn into their regions. Bars use partial cell glyphs
+ * allocated in CGRAM on demand, glyphs stay in their slots as long as
+ * some bar needs them. Scrollers move in memory, HD44780 display shift
+ * would move every row at once. Frame widgets and keys aren't supported.
+ *
+ */
+class LcdprocServer
+{
+    private:
+	struct t_Widget {
+	    string id;
+	    string type;
+	    int x, y, right, bottom;
+	    int length;
+	    char direction;
+	    int speed;
+	    string text;
+	};
+
+	struct t_Screen {
+	    unsigned client;
+	    string id;
+	    int priority;
+	    unsigned duration;
+	    std::vector<t_Widget> widgets;
+	};
+
+	uint8_t cols;
+	uint8_t nrows;
+	std::vector<t_Screen> screens;
+	std::vector<std::pair<unsigned, string> > notices;
+	int active;
+	uint64_t shownat;
+	uint8_t shapes[8];
+
+	t_Screen *_screen(unsigned client, const string &id);
+	t_Widget *_widget(t_Screen *screen, const string &id);
+	void _show(int index, uint64_t ms);
+	void _glyphs(const t_Screen &screen, FrameBuffer &frame);
+	int _slot(uint8_t shape) const;
+	bool _inside(int x, int y) const;
+	void _draw(const t_Widget &widget, uint64_t ms, FrameBuffer &frame);
+
+	static bool _split(const string &line, std::vector<string> &args);
+	static int _priority(const string &value);
+
+    public:
+	LcdprocServer(uint8_t columns, uint8_t rows);
+
+	void command(unsigned client, const string &line, string &answer);
+	void disconnect(unsigned client);
+	bool render(uint64_t ms, FrameBuffer &frame);
+	std::vector<std::pair<unsigned, string> > &getNotices(void) { return notices; };
+};
+
+};
+
+#endif
@@ -0,0 +1,137 @@
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+
+#include <linesink.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief LineSink class constructor. Display must be powered on,
+ * its content is kept until lines arrive.
+ *
+ * @param display
+ * @param refreshms shortest time between display updates
+ **/
+LineSink::LineSink(I2Lcd &display, unsigned refreshms) : lcd(display), frame(display.getScreen()),
+    refresh(refreshms), pinned(0), dirty(false), lines(0), flushes(0)
+{
+}
+
+/**
+ * @brief Put one line into frame. Line is clipped to display width,
+ * rest of the row is cleared.
+ *
+ * @param text line without '\\n'
+ **/
+void LineSink::line(const string &text)
+{
+    uint8_t row = frame.rows(), r, prev = frame.rows();
+    size_t start = 0;
+
+    if (text.size() > 2 && text[0] == '@' && text[1] >= '0' && text[1] <= '9' && text[2] == ' ')
+    {
+	row = text[1] - '0';
+	if (row >= frame.rows())
+	    return;
+	pinned |= 1 << row;
+	start = 3;
+    } else
+	for (r = 0; r < frame.rows(); r++)
+	{
+	    if (pinned & (1 << r))
+		continue;
+	    if (prev < frame.rows())
+		frame.put(0, prev, frame.row(r), frame.columns());
+	    prev = row = r;
+	}
+    if (row >= frame.rows())
+	return;
+
+    frame.put(0, row, string(frame.columns(), ' ').c_str(), frame.columns());
+    frame.put(0, row, text.data() + start, text.size() - start);
+    dirty = true;
+    lines++;
+}
+
+/**
+ * @brief Feed raw data, complete lines are put into frame,
+ * unterminated tail waits for more data. '\\r' is dropped.
+ *
+ * @param data
+ * @param len
+ **/
+void LineSink::feed(const char *data, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+	if (data[i] == '\n')
+	{
+	    line(partial);
+	    partial.clear();
+	} else if (data[i] != '\r')
+	    partial += data[i];
+}
+
+/**
+ * @brief Send changed cells to display
+ **/
+void LineSink::flush(void)
+{
+    if (!dirty)
+	return;
+    lcd.show(frame);
+    dirty = false;
+    flushes++;
+}
+
+/**
+ * @brief Read from file descriptor until end of file. Display is
+ * updated when refresh period passed since last update, everything
+ * arriving meanwhile is coalesced.
+ *
+ * @param fd descriptor to read, like stdin or opened FIFO
+ * @return false on read error
+ **/
+bool LineSink::run(int fd)
+{
+    struct pollfd pfd;
+    uint64_t last = 0, now;
+    char buf[4096];
+    ssize_t n;
+    int timeout;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    for (;;)
+    {
+	now = monotonicMs();
+	if (dirty && now - last >= refresh)
+	{
+	    flush();
+	    last = now = monotonicMs();
+	}
+	timeout = dirty ? (int) (refresh - (now - last)) : -1;
+	if (poll(&pfd, 1, timeout) < 0)
+	{
+	    if (errno == EINTR)
+		continue;
+	    return false;
+	}
+	if (!pfd.revents)
+	    continue;
+
+	n = read(fd, buf, sizeof(buf));
+	if (n < 0 && errno == EINTR)
+	    continue;
+	if (n <= 0)
+	{
+	    if (!partial.empty())
+		feed("\n", 1);
+	    flush();
+	    return n == 0;
+	}
+	feed(buf, n);
+    }
+}
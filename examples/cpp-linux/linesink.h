@@ -0,0 +1,54 @@
+#ifndef __LINESINK_H__
+#define __LINESINK_H__
+
+#include <cstdint>
+#include <string>
+
+#include <i2lcd.h>
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+#define LINESINK_REFRESH_MS	50
+
+/**
+ * @class LineSink
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Maps newline delimited text stream onto display rows.
+ *
+ * Lines scroll up from the bottom row, like tail of a log. Line starting
+ * with "@<row> " is put on that row instead, and the row is left out
+ * of scrolling from then on. Lines only
+ * change in-memory frame, display gets what changed at most once per
+ * refresh period, so bursts are coalesced and the newest lines win.
+ *
+ */
+class LineSink
+{
+    private:
+	I2Lcd &lcd;
+	FrameBuffer frame;
+	string partial;
+	unsigned refresh;
+	uint8_t pinned;
+	bool dirty;
+	unsigned long lines;
+	unsigned long flushes;
+
+    public:
+	LineSink(I2Lcd &display, unsigned refreshms = LINESINK_REFRESH_MS);
+
+	void line(const string &text);
+	void feed(const char *data, size_t len);
+	void flush(void);
+	bool run(int fd);
+
+	unsigned long getLines(void) const { return lines; };
+	unsigned long getFlushes(void) const { return flushes; };
+};
+
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <marquee.h>
+
+using namespace i2lcd;
+
+/**
+ * Ticker on 16x2 display on simulated 100 kHz bus, texts fitting the
+ * 40 byte DDRAM line and longer than it. Marquee stepping by display
+ * shift is compared with setCursor() and print() of the whole row every
+ * step. Visible row is checked against the expected window after each
+ * step.
+ *
+ * usage: marqbench [steps]
+ */
+
+static std::string texts[] = {
+    "Next train 17:42 platform 3",
+    "Breaking: ticker text longer than forty characters streams through "
+    "off-screen cells of DDRAM while the display shift moves it along",
+};
+
+int main(int argc, char **argv)
+{
+    unsigned steps = argc > 1 ? atoi(argv[1]) : 200;
+    unsigned t, i, mode, errors = 0;
+    std::string loop, window;
+    SimBus bus(100000);
+    I2Lcd lcd(bus, 0x20, D16x2);
+
+    lcd.power(POWERON);
+    printf("text  mode      bytes/step  bus ms/step  errors\n");
+    for (t = 0; t < 2; t++)
+	for (mode = 0; mode < 2; mode++)
+	{
+	    loop = texts[t] + std::string(MARQUEE_GAP, ' ');
+	    if (loop.size() < 40)
+		loop.resize(40, ' ');
+	    errors = 0;
+	    lcd.clear();
+	    {
+		Marquee marquee(lcd, 0);
+
+		if (!mode)
+		    marquee.setText(texts[t]);
+		bus.resetCounters();
+		for (i = 1; i <= steps; i++)
+		{
+		    window.clear();
+		    while (window.size() < lcd.columns())
+			window += loop[(i + window.size()) % loop.size()];
+		    if (mode)
+		    {
+			lcd.setCursor(0, 0);
+			lcd.print(window);
+		    } else
+			marquee.step();
+		    if (bus.visible(0x20, lcd.type(), 0) != window)
+			errors++;
+		}
+		printf("%4u  %-8s %11.1f %12.2f %7u\n", (unsigned) texts[t].size(), mode ? "print" : "marquee",
+		    (double) bus.getBytes() / steps, bus.getWireTime() / 1000000.0 / steps, errors);
+	    }
+	}
+}
@@ -0,0 +1,162 @@
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+#include <marquee.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Marquee class constructor, starts stopped with empty text.
+ * Display is returned home, DDRAM line of the row is cleared.
+ *
+ * @param display
+ * @param row row of the ticker
+ **/
+Marquee::Marquee(I2Lcd &display, uint8_t row) : lcd(display), row(row), offset(0), position(0), shifts(0),
+    writes(0)
+{
+    if (lcd.rows() > 2)
+	throw tMarqueeRows;
+    line = lcd.type().getLine() ? 40 : MARQUEE_LINE;
+    base = lcd.type()[row];
+    lcd.home();
+    memset(ddram, ' ', sizeof(ddram));
+    _put(0, ddram, line);
+    text = string(line, ' ');
+    timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    wakefd = eventfd(0, EFD_CLOEXEC);
+    worker = std::thread(&Marquee::_run, this);
+}
+
+/**
+ * @brief Marquee class destructor, stops the ticker and
+ * returns display home
+ **/
+Marquee::~Marquee()
+{
+    uint64_t v = 1;
+
+    if (write(wakefd, &v, sizeof(v)) < 0) {};
+    worker.join();
+    close(timerfd);
+    close(wakefd);
+    lcd.home();
+}
+
+/**
+ * @brief Helper writing cells of the line and its copy.
+ * This method is private
+ **/
+void Marquee::_put(uint8_t cell, const char *data, uint8_t len)
+{
+    lcd.writeDD(base + cell, data, len);
+    memcpy(ddram + cell, data, len);
+    writes += len;
+}
+
+/**
+ * @brief Set text, starting at the left edge of the window. Only
+ * cells holding different character are written.
+ *
+ * @param value text, any length
+ * @param gap spaces between end and start of text
+ **/
+void Marquee::setText(const string &value, uint8_t gap)
+{
+    std::lock_guard<std::recursive_mutex> guard(lcd.busLock());
+    char next[MARQUEE_LINE];
+    uint8_t k, cell, first;
+
+    text = value + string(gap, ' ');
+    if (text.size() < line)
+	text.resize(line, ' ');
+    position = 0;
+
+    for (k = 0; k < line; k++)
+	next[(offset + k) % line] = text[k % text.size()];
+    for (cell = 0; cell < line; cell++)
+    {
+	if (next[cell] == ddram[cell])
+	    continue;
+	first = cell;
+	while (cell + 1 < line && next[cell + 1] != ddram[cell + 1])
+	    cell++;
+	_put(first, next + first, cell - first + 1);
+    }
+}
+
+/**
+ * @brief Move text one position left. At most one off-screen
+ * cell is written, none when text fits the line.
+ **/
+void Marquee::step(void)
+{
+    std::lock_guard<std::recursive_mutex> guard(lcd.busLock());
+    uint8_t cell = offset;
+    char c;
+
+    lcd.shiftDisplay(false);
+    shifts++;
+    offset = (offset + 1) % line;
+    position = (position + 1) % text.size();
+    c = text[(position + line - 1) % text.size()];
+    if (ddram[cell] != c)
+	_put(cell, &c, 1);
+}
+
+/**
+ * @brief Start moving text in background thread
+ *
+ * @param stepms period of steps in milliseconds
+ **/
+void Marquee::start(unsigned stepms)
+{
+    struct itimerspec its = {};
+
+    if (!stepms)
+	stepms = 1;
+    its.it_interval.tv_sec = stepms / 1000;
+    its.it_interval.tv_nsec = (stepms % 1000) * 1000000;
+    its.it_value = its.it_interval;
+    timerfd_settime(timerfd, 0, &its, NULL);
+}
+
+/**
+ * @brief Stop moving text, it stays where it is
+ **/
+void Marquee::stop(void)
+{
+    struct itimerspec its = {};
+
+    timerfd_settime(timerfd, 0, &its, NULL);
+}
+
+/**
+ * @brief Ticker thread loop. This method is private
+ **/
+void Marquee::_run(void)
+{
+    struct pollfd fds[2];
+    uint64_t v;
+
+    fds[0].fd = timerfd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakefd;
+    fds[1].events = POLLIN;
+
+    for (;;)
+    {
+	if (poll(fds, 2, -1) < 0)
+	    continue;
+	if (fds[1].revents & POLLIN)
+	    break;
+	if (fds[0].revents & POLLIN)
+	{
+	    if (read(timerfd, &v, sizeof(v)) < 0) {};
+	    step();
+	}
+    }
+}
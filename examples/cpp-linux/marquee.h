@@ -0,0 +1,85 @@
+#ifndef __MARQUEE_H__
+#define __MARQUEE_H__
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <mutex>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+#define MARQUEE_GAP	4
+#define MARQUEE_LINE	80
+
+/**
+ * @class MarqueeRows
+ *
+ * @ingroup i2lcd
+ *
+ * @brief MarqueeRows Exception class thrown for displays with more than
+ *        2 rows, where rows share DDRAM lines
+ *
+ *
+ */
+class MarqueeRows: public exception
+{
+} tMarqueeRows;
+
+/**
+ * @class Marquee
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Ticker moving text by HD44780 display shift.
+ *
+ * Text with a gap is laid out once into whole DDRAM line of the row, 40
+ * bytes in 2 line mode and 80 in 1 line mode, and each step is a single
+ * CURSOR_DISPLAY_SHIFT command. Texts longer than the line are streamed:
+ * cell which just left the window is the farthest off-screen cell, it gets
+ * the character it will show when it comes round again, so every write
+ * lands off-screen. New text rewrites only cells which differ.
+ *
+ * Display shift moves all rows, so the marquee owns shifting of the
+ * display and the other row of 2 row display moves along. Displays with
+ * more rows share lines between rows and throw tMarqueeRows. Destructor
+ * returns the display home.
+ *
+ */
+class Marquee
+{
+    private:
+	I2Lcd &lcd;
+	uint8_t row;
+	uint8_t base;
+	uint8_t line;
+	string text;
+	char ddram[MARQUEE_LINE];
+	uint8_t offset;
+	size_t position;
+	unsigned long shifts;
+	unsigned long writes;
+	int timerfd;
+	int wakefd;
+	std::thread worker;
+
+	void _put(uint8_t cell, const char *data, uint8_t len);
+	void _run(void);
+
+    public:
+	Marquee(I2Lcd &display, uint8_t row = 0);
+	~Marquee();
+
+	void setText(const string &value, uint8_t gap = MARQUEE_GAP);
+	void step(void);
+	void start(unsigned stepms);
+	void stop(void);
+
+	unsigned long getShifts(void) const { return shifts; };
+	unsigned long getWrites(void) const { return writes; };
+};
+
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include <algorithm>
+
+#include <mirror.h>
+#include <lcdcore.h>
+#include <pots.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Helper giving global order of bus locks: by address,
+ * then by object for two objects of one display
+ **/
+bool LcdMirror::_before(const I2Lcd *a, const I2Lcd *b)
+{
+    if (a->getAddress() != b->getAddress())
+	return a->getAddress() < b->getAddress();
+    return a < b;
+}
+
+/**
+ * @brief Add display to the group
+ *
+ * @param lcd display on mirror's bus, of the same type as other members
+ * @return false if display doesn't fit the group
+ **/
+bool LcdMirror::add(I2Lcd &lcd)
+{
+    struct i2c_msg msg;
+
+    if (&lcd.getInterface() != &bus)
+	return false;
+    if (!members.empty() && (lcd.columns() != members[0]->columns() || lcd.rows() != members[0]->rows()))
+	return false;
+
+    msg.addr = lcd.getAddress();
+    msg.flags = 0;
+    msg.len = 0;
+    msg.buf = NULL;
+    members.push_back(&lcd);
+    locks.insert(std::upper_bound(locks.begin(), locks.end(), &lcd, _before), &lcd);
+    msgs.push_back(msg);
+    groups.push_back(0);
+    return true;
+}
+
+/**
+ * @brief Check if all members show the same, so diff against
+ * first member's screen is valid for all of them
+ **/
+bool LcdMirror::_same(void) const
+{
+    size_t i;
+
+    for (i = 0; i < members.size(); i++)
+	if (!members[i]->screenvalid || (i && !(*members[i]->screen == *members[0]->screen)))
+	    return false;
+    return true;
+}
+
+/**
+ * @brief Encode operations into message buffers, once for every
+ * CPORT base in bases. RS is set up in separate write before EN
+ * rises, only when it changes, so every copy has the same layout,
+ * copy of bases[g] starts at g * stride.
+ **/
+void LcdMirror::_encode(void)
+{
+    t_Slot slot;
+    uint8_t *p;
+    int rs;
+    size_t g, i;
+
+    slots.clear();
+    bytes.resize(bases.size() * ops.size() * LCDCORE_OPBYTES);
+    for (g = 0; g < bases.size(); g++)
+    {
+	rs = -1;
+	p = &bytes[g * stride];
+	slot.offset = 0;
+	for (i = 0; i < ops.size(); i++)
+	{
+	    slot.us = I2Lcd::execTime(ops[i].rs, ops[i].value);
+	    slot.len = lcdEncode(p + slot.offset, bases[g], rs, ops[i].rs, ops[i].value) - (p + slot.offset);
+	    if (!g)
+		slots.push_back(slot);
+	    slot.offset += slot.len;
+	}
+	stride = slot.offset;
+    }
+}
+
+/**
+ * @brief Send encoded operations to all members, one transfer per
+ * operation, waiting for execution time of previous one
+ **/
+void LcdMirror::_replay(void)
+{
+    uint64_t readyat = 0;
+    size_t i, j;
+
+    for (i = 0; i < members.size(); i++)
+	if (members[i]->readyat > readyat)
+	    readyat = members[i]->readyat;
+
+    for (i = 0; i < slots.size(); i++)
+    {
+	for (j = 0; j < msgs.size(); j++)
+	{
+	    msgs[j].len = slots[i].len;
+	    msgs[j].buf = &bytes[groups[j] * stride + slots[i].offset];
+	}
+	sleepUntil(readyat);
+	bus.transfer(&msgs[0], msgs.size());
+	readyat = monotonicNs() + (uint64_t) slots[i].us * 1000;
+	transfers++;
+    }
+
+    for (i = 0; i < members.size(); i++)
+	members[i]->readyat = readyat;
+}
+
+/**
+ * @brief Show frame on every member
+ *
+ * @param frame content
+ **/
+void LcdMirror::show(const FrameBuffer &frame)
+{
+    std::vector<std::unique_lock<std::recursive_mutex> > guards;
+    I2Lcd *first;
+    t_LcdOp op;
+    uint8_t base;
+    size_t i, g;
+
+    if (members.empty())
+	return;
+    first = members[0];
+    for (i = 0; i < locks.size(); i++)
+    {
+	guards.push_back(std::unique_lock<std::recursive_mutex>(locks[i]->buslock));
+	locks[i]->port->flush();
+    }
+
+    ops.clear();
+    first->screen->update(frame, first->lcdtype, ops, !_same());
+    if (ops.empty())
+	return;
+    op.rs = false;
+    op.value = (1 << SET_DDRAM_ADDRESS) | first->lcdtype.ddAddress(first->column, first->row);
+    ops.push_back(op);
+
+    bases.clear();
+    for (i = 0; i < members.size(); i++)
+    {
+	base = members[i]->port->get() & ~(RS | RW | EN);
+	for (g = 0; g < bases.size() && bases[g] != base; g++) {};
+	if (g == bases.size())
+	    bases.push_back(base);
+	groups[i] = g;
+    }
+    stride = ops.size() * LCDCORE_OPBYTES;
+    _encode();
+    _replay();
+
+    for (i = 0; i < members.size(); i++)
+    {
+	members[i]->port->assume(bases[groups[i]]);
+	members[i]->commands[SET_DDRAM_ADDRESS] = ops.back().value;
+	members[i]->column = first->column;
+	members[i]->row = first->row;
+	if (i)
+	    *members[i]->screen = *first->screen;
+	members[i]->screenvalid = true;
+    }
+}
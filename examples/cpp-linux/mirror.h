@@ -0,0 +1,74 @@
+#ifndef __MIRROR_H__
+#define __MIRROR_H__
+
+#include <cstdint>
+#include <vector>
+#include <linux/i2c.h>
+
+#include <i2lcd.h>
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+/**
+ * @class LcdMirror
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Group of identical displays on one bus showing the same content.
+ *
+ * Frame is diffed and encoded into PCA9535 writes once. Every HD44780
+ * operation becomes one message holding whole EN pulse (OUTPUT0/OUTPUT1
+ * pair is written twice thanks to register auto-increment), and the same
+ * message buffer is sent to every member in single I2C_RDWR transfer.
+ * Encoding cost and transfer count don't grow with number of mirrors,
+ * only bus bytes do.
+ *
+ * Members must be of the same type and created on the same bus. Pending
+ * potentiometer moves are finished before the frame is sent. Every member
+ * keeps its own CPORT lines (PWR, pot UD and CS), frame is encoded once
+ * for each distinct CPORT value among members. Bus locks of members are
+ * taken in order of their addresses, so mirrors sharing displays can't
+ * deadlock. After show() every member has cursor of the first one.
+ *
+ */
+class LcdMirror
+{
+    private:
+	struct t_Slot {
+	    size_t offset;
+	    uint8_t len;
+	    uint16_t us;
+	};
+
+	I2CBus &bus;
+	std::vector<I2Lcd*> members;
+	std::vector<I2Lcd*> locks;
+	std::vector<struct i2c_msg> msgs;
+	std::vector<t_LcdOp> ops;
+	std::vector<t_Slot> slots;
+	std::vector<uint8_t> bases;
+	std::vector<size_t> groups;
+	std::vector<uint8_t> bytes;
+	size_t stride;
+	unsigned long transfers;
+
+	static bool _before(const I2Lcd *a, const I2Lcd *b);
+	bool _same(void) const;
+	void _encode(void);
+	void _replay(void);
+
+    public:
+	LcdMirror(I2CBus &busi) : bus(busi), stride(0), transfers(0) {};
+
+	bool add(I2Lcd &lcd);
+	unsigned size(void) const { return members.size(); };
+	I2Lcd &member(unsigned index) { return *members[index]; };
+	void show(const FrameBuffer &frame);
+
+	unsigned long getTransfers(void) const { return transfers; };
+};
+
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+#include <vector>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <framebuffer.h>
+#include <mirror.h>
+
+using namespace i2lcd;
+
+/**
+ * Cost of showing the same frames on 1, 2, 4 and 8 identical 20x4
+ * displays on one simulated 100 kHz bus. Each display showing frame
+ * on its own is compared with LcdMirror encoding the frame once.
+ * CPU time excludes sleeping, transfers count I2C_RDWR calls.
+ *
+ * usage: mirrorbench [frames]
+ */
+
+static double _cpu(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void _compose(FrameBuffer &frame, unsigned n)
+{
+    char line[32];
+    unsigned row;
+
+    for (row = 0; row < 4; row++)
+    {
+	snprintf(line, sizeof(line), "Line %u counter %5u", row, n * 3 + row);
+	frame.print(0, row, line);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned frames = argc > 1 ? atoi(argv[1]) : 50;
+    unsigned counts[] = {1, 2, 4, 8};
+    unsigned c, i, f, n;
+    unsigned long v;
+    double t;
+
+    printf("displays  mode      cpu us/frame  transfers  messages  violations\n");
+    for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+	SimBus bus(100000);
+	std::vector<I2Lcd*> lcds;
+	FrameBuffer frame(20, 4);
+	LcdMirror mirror(bus);
+
+	n = counts[c];
+	for (i = 0; i < n; i++)
+	{
+	    lcds.push_back(new I2Lcd(bus, 0x20 + i, D20x4));
+	    lcds[i]->power(POWERON);
+	    mirror.add(*lcds[i]);
+	}
+
+	bus.resetCounters();
+	t = _cpu();
+	for (f = 0; f < frames; f++)
+	{
+	    _compose(frame, f);
+	    for (i = 0; i < n; i++)
+		lcds[i]->show(frame);
+	}
+	t = _cpu() - t;
+	for (v = 0, i = 0; i < n; i++)
+	    v += bus.module(0x20 + i).violations;
+	printf("%8u  %-8s %13.1f  %9lu  %8lu  %10lu\n", n, "each", t * 1e6 / frames, bus.getTransactions(), bus.getMessages(), v);
+
+	bus.resetCounters();
+	t = _cpu();
+	for (f = 0; f < frames; f++)
+	{
+	    _compose(frame, f + frames);
+	    mirror.show(frame);
+	}
+	t = _cpu() - t;
+	for (v = 0, i = 0; i < n; i++)
+	    v += bus.module(0x20 + i).violations;
+	printf("%8u  %-8s %13.1f  %9lu  %8lu  %10lu\n", n, "mirror", t * 1e6 / frames, bus.getTransactions(), bus.getMessages(), v);
+
+	for (i = 0; i < n; i++)
+	{
+	    if (bus.visible(0x20 + i, D20x4, 3) != frame.text(3))
+		printf("display %u differs\n", i);
+	    delete lcds[i];
+	}
+    }
+}
@@ -0,0 +1,130 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include <glyphpack.h>
+
+using namespace i2lcd;
+
+/**
+ * Builds glyph pack from C headers saved by editlcd (gcbitmap.h style,
+ * binary or hex numbers, 8 per glyph) or lists glyphs of a pack.
+ * Glyphs are named after the header file and their number, like
+ * gcbitmap0, or after the name given as name=file.h.
+ *
+ * usage: mkglyphs pack.glp [name=]file.h ...
+ *        mkglyphs -l pack.glp
+ */
+
+static void _usage(const char *name)
+{
+    fprintf(stderr, "usage: %s pack.glp [name=]file.h ...\n       %s -l pack.glp\n", name, name);
+    exit(1);
+}
+
+static int _list(const char *path)
+{
+    uint8_t r, x;
+    unsigned i;
+
+    try
+    {
+	GlyphPack pack(path);
+
+	for (i = 0; i < pack.count(); i++)
+	{
+	    printf("%-24s", pack.name(i).c_str());
+	    for (r = 0; r < 8; r++)
+		printf(" %02x", pack.bitmap(i)[r] & 0x1f);
+	    printf("   ");
+	    for (r = 0; r < 8; r++)
+	    {
+		for (x = 0; x < 5; x++)
+		    putchar(pack.bitmap(i)[r] & (0x10 >> x) ? '#' : '.');
+		putchar(r < 7 ? '|' : '\n');
+	    }
+	}
+    } catch (std::exception &e)
+    {
+	fprintf(stderr, "%s isn't glyph pack\n", path);
+	return 1;
+    }
+    return 0;
+}
+
+static bool _parse(const char *arg, std::vector<std::string> &names, std::vector<std::string> &bitmaps)
+{
+    std::string prefix, text, glyph;
+    const char *path = arg, *eq = strchr(arg, '='), *p;
+    unsigned number = 0;
+    char *end;
+    FILE *f;
+    int c;
+
+    if (eq)
+    {
+	prefix.assign(arg, eq - arg);
+	path = eq + 1;
+    } else
+    {
+	p = strrchr(path, '/');
+	prefix = p ? p + 1 : path;
+	prefix = prefix.substr(0, prefix.find('.'));
+    }
+    f = fopen(path, "r");
+    if (!f)
+	return false;
+    while ((c = fgetc(f)) != EOF)
+	text += (char) c;
+    fclose(f);
+
+    for (p = text.c_str(); *p; p++)
+    {
+	if (p[0] != '0' || (tolower(p[1]) != 'x' && tolower(p[1]) != 'b') || (p > text.c_str() && isalnum(p[-1])))
+	    continue;
+	glyph += (char) (strtol(p + 2, &end, tolower(p[1]) == 'x' ? 16 : 2) & 0x1f);
+	p = end - 1;
+	if (glyph.size() == 8)
+	{
+	    names.push_back(prefix + std::to_string(number++));
+	    bitmaps.push_back(glyph);
+	    glyph.clear();
+	}
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> names, bitmaps;
+    std::vector<const char *> n, b;
+    size_t j;
+    int i;
+
+    if (argc == 3 && !strcmp(argv[1], "-l"))
+	return _list(argv[2]);
+    if (argc < 3)
+	_usage(argv[0]);
+
+    for (i = 2; i < argc; i++)
+	if (!_parse(argv[i], names, bitmaps))
+	{
+	    fprintf(stderr, "can't read %s\n", argv[i]);
+	    return 1;
+	}
+    for (j = 0; j < names.size(); j++)
+    {
+	n.push_back(names[j].c_str());
+	b.push_back(bitmaps[j].data());
+    }
+    if (!GlyphPack::write(argv[1], n.data(), b.data(), n.size()))
+    {
+	fprintf(stderr, "can't write %s\n", argv[1]);
+	return 1;
+    }
+    printf("%u glyphs written to %s\n", (unsigned) n.size(), argv[1]);
+    return 0;
+}
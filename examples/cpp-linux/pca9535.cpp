@@ -1,9 +1,3 @@
-#include <fcntl.h>
-#include <sys/ioctl.h>
-#include <linux/i2c-dev.h>
-
-#include <unistd.h>
-
 #include <iostream>
 #include <string>
 #include <cstdio>
@@ -12,20 +6,21 @@
 using namespace i2lcd;
 
 /**
- * @brief Class constructor
+ * @brief Class constructor, chip gets its own /dev/i2c-N device
  * @param bus number
  * @param chip address
  **/
-PCA9535::PCA9535(uint8_t busn, uint8_t addressn) : bus(busn), address(addressn)
+PCA9535::PCA9535(uint8_t busn, uint8_t addressn) : iface(new I2CDevBus(busn)), owner(true), address(addressn)
 {
-    string s = "/dev/i2c-" + to_string(bus);
-
-    fileh = open(s.c_str(), O_RDWR);
-    if (fileh == -1)
-	throw tPEXOpen;
+}
 
-    if (ioctl(fileh, I2C_SLAVE, address) < 0)
-	throw tPEXIOctl;
+/**
+ * @brief Class constructor, chip shares bus with other chips
+ * @param bus interface
+ * @param chip address
+ **/
+PCA9535::PCA9535(I2CBus &busi, uint8_t addressn) : iface(&busi), owner(false), address(addressn)
+{
 }
 
 /**
@@ -33,31 +28,31 @@ PCA9535::PCA9535(uint8_t busn, uint8_t addressn) : bus(busn), address(addressn)
  **/
 PCA9535::~PCA9535()
 {
-    if (fileh)
-	close(fileh);
+    if (owner)
+	delete iface;
 }
 
 
 /**
  * @brief Private method hiding the fact we're
- *        using linux file to access I2C bus
+ *        using I2C bus
  * @param register number
  * @param value to set
  **/
 void PCA9535::_setRegister(t_PCARegs port, uint8_t value)
 {
-    i2c_smbus_write_byte_data(fileh, port, value);
+    iface->writeRegister(address, port, value);
 }
 
 /**
  * @brief Private method hiding the fact we're
- *        using linux file to access I2C bus
+ *        using I2C bus
  * @param register number
  * @return value of given register
  **/
 uint8_t PCA9535::_getRegister(t_PCARegs port) const
 {
-    return i2c_smbus_read_byte_data(fileh, port);
+    return iface->readRegister(address, port);
 }
 
 /**
@@ -104,6 +99,17 @@ void PCA9535::setOutput(t_PCAPort port, uint8_t value)
     _setRegister((t_PCARegs) (OUTPUT0 + port), value);
 }
 
+/**
+ * @brief Set both output registers in one bus transaction.
+ *        CPORT is updated first, then DPORT.
+ * @param cport value of CPORT outputs
+ * @param dport value of DPORT outputs
+ **/
+void PCA9535::setOutputs(uint8_t cport, uint8_t dport)
+{
+    iface->writeRegisters(address, OUTPUT0, cport, dport);
+}
+
 /**
  * @brief Return current output register
  * @param port number
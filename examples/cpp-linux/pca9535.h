@@ -5,6 +5,8 @@
 #include <string>
 #include <exception>
 
+#include <i2cbus.h>
+
 using namespace std;
 
 namespace i2lcd {
@@ -67,8 +69,8 @@ class PEXIOctl: public exception
 class PCA9535
 {
     private:
-	int fileh;
-	uint8_t bus;
+	I2CBus *iface;
+	bool owner;
 	uint8_t address;
 	void _setRegister(t_PCARegs port, uint8_t value);
 	uint8_t _getRegister(t_PCARegs port) const;
@@ -76,9 +78,14 @@ class PCA9535
 
     public:
 	PCA9535(uint8_t busn, uint8_t addressn);
+	PCA9535(I2CBus &busi, uint8_t addressn);
 	~PCA9535();
 	void testPCA9535();
 
+	I2CBus &getInterface() const { return *iface; };
+	uint8_t getBus() const { return iface->getNumber(); };
+	uint8_t getAddress() const { return address; };
+
 
 	uint8_t getDirection(t_PCAPort port) const;
 	void setDirection(t_PCAPort port, uint8_t direction);
@@ -86,6 +93,7 @@ class PCA9535
 	uint8_t getPort(t_PCAPort port) const;
 
 	void setOutput(t_PCAPort, uint8_t value);
+	void setOutputs(uint8_t cport, uint8_t dport);
 	uint8_t getOutput(t_PCAPort port) const;
 
 	uint8_t getPolarity(t_PCAPort port) const;
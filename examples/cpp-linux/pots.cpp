@@ -1,6 +1,12 @@
 
+#include <fcntl.h>
 #include <unistd.h>
 #include <time.h>
+#include <sys/mman.h>
+
+#include <cstdio>
+#include <cstring>
+
 #include <pots.h>
 
 using namespace i2lcd;
@@ -19,25 +25,299 @@ inline int nsleep(long nanos)
 }
 
 /**
- * @brief Class constructor
- * @param PCA9535 chip class for communication with pots.
- * @param cs - line number where CS line of MCP401x is connected to
- * @param ud - line number where UD line of MCP401x is connected to
+ * @brief PotState class constructor.
+ *        Opens (or creates) state file for module at given bus and address
+ *        and maps it into memory. If file can't be used, object stays
+ *        invalid and potentiometers will be homed as usual.
+ * @param dir directory of state files
+ * @param bus number
+ * @param address chip address
  **/
-Potentiometer::Potentiometer(PCA9535 &chip, t_PotBits cs, t_PotBits ud) : current(0), csb((uint8_t) cs), udb((uint8_t) ud), iface(chip)
+PotState::PotState(const char *dir, uint8_t bus, uint8_t address) : fileh(-1), state(NULL)
 {
-    uint8_t tmp;
+    char path[256];
+    void *m;
+
+    if (!dir)
+	return;
+
+    snprintf(path, sizeof(path), "%s/i2lcd-%u-%02x.pots", dir, bus, address);
+    fileh = open(path, O_RDWR | O_CREAT, 0644);
+    if (fileh == -1)
+	return;
+
+    if (ftruncate(fileh, sizeof(t_PotStateFile)) == -1)
+	return;
+
+    m = mmap(NULL, sizeof(t_PotStateFile), PROT_READ | PROT_WRITE, MAP_SHARED, fileh, 0);
+    if (m == MAP_FAILED)
+	return;
+    state = (t_PotStateFile*) m;
+
+    if (state->magic != POTSTATE_MAGIC || state->version != POTSTATE_VERSION ||
+	state->bus != bus || state->address != address)
+    {
+	memset(state, 0, sizeof(t_PotStateFile));
+	state->magic = POTSTATE_MAGIC;
+	state->version = POTSTATE_VERSION;
+	state->bus = bus;
+	state->address = address;
+    }
+}
+
+/**
+ * @brief PotState class destructor
+ **/
+PotState::~PotState()
+{
+    if (state)
+	munmap(state, sizeof(t_PotStateFile));
+    if (fileh != -1)
+	close(fileh);
+}
+
+/**
+ * @brief Return record for potentiometer selected by given CS line
+ * @param csb CS line of the potentiometer
+ * @return record address or NULL if state is not available
+ **/
+t_PotRecord *PotState::record(t_PotBits csb)
+{
+    if (!state)
+	return NULL;
+    return &state->pots[csb == BACKLIGHT_CS ? 1 : 0];
+}
+
+/**
+ * @brief ControlPort class constructor
+ * @param chip PCA9535 chip, which CPORT is owned by this object
+ * @param initial value of CPORT outputs
+ * @param ud line where UD line of MCP401x pots is connected to
+ **/
+ControlPort::ControlPort(PCA9535 &chip, uint8_t initial, t_PotBits ud) : iface(chip), shadow(initial), udb((uint8_t) ud),
+                                                                     potmask((uint8_t) ud), npots(0)
+{
+    iface.setOutput(CPORT, shadow);
+}
+
+/**
+ * @brief Register potentiometer, which pulses will be merged into CPORT writes
+ * @param pot potentiometer
+ **/
+void ControlPort::attach(Potentiometer *pot)
+{
+    if (npots < 2)
+    {
+	pots[npots++] = pot;
+	potmask |= pot->csb;
+    }
+}
+
+/**
+ * @brief Unregister potentiometer
+ * @param pot potentiometer
+ **/
+void ControlPort::detach(Potentiometer *pot)
+{
+    uint8_t i;
+
+    for (i = 0; i < npots; i++)
+	if (pots[i] == pot)
+	{
+	    pots[i] = pots[--npots];
+	    break;
+	}
+}
+
+/**
+ * @brief Compute next CPORT value. LCD lines are taken from value,
+ *        pot lines advance pot protocol by at most one action:
+ *        release finished pots, latch direction of idle pots,
+ *        toggle UD or prepare UD level for latching.
+ *        Counting edge is rising UD for increment and falling
+ *        for decrement, as MCP401x datasheet says. Every latched
+ *        pot counts the edge, wiper stops at both ends of its range.
+ *        This method is private
+ * @param value requested state of LCD lines
+ * @return value to write to CPORT
+ **/
+uint8_t ControlPort::_next(uint8_t value)
+{
+    uint8_t out = (value & ~potmask) | (shadow & potmask);
+    bool ud = shadow & udb;
+    bool latched = false, mode = false, pending = false;
+    bool idle = false, dir = false, changed = false;
+    Potentiometer *p;
+    uint8_t i, t;
+
+    for (i = 0; i < npots; i++)
+    {
+	p = pots[i];
+	if (p->latched)
+	{
+	    latched = true;
+	    mode = p->up;
+	    pending |= p->pending();
+	} else
+	{
+	    t = p->target.load(std::memory_order_relaxed);
+	    if (t != p->current && !idle)
+	    {
+		idle = true;
+		dir = t > p->current;
+	    }
+	}
+    }
+
+    if (latched && ud == mode)
+    {
+	for (i = 0; i < npots; i++)
+	{
+	    p = pots[i];
+	    if (p->latched && !p->pending())
+	    {
+		out |= p->csb;
+		p->latched = false;
+		p->commit();
+		changed = true;
+	    }
+	}
+	if (changed)
+	    return out;
+    }
+
+    if (idle && ud == dir && (!latched || mode == dir))
+    {
+	for (i = 0; i < npots; i++)
+	{
+	    p = pots[i];
+	    t = p->target.load(std::memory_order_relaxed);
+	    if (!p->latched && t != p->current && (t > p->current) == dir)
+	    {
+		out &= ~p->csb;
+		p->latched = true;
+		p->up = dir;
+		p->begin();
+	    }
+	}
+	return out;
+    }
 
-    tmp = iface.getDirection(CPORT);
-    iface.setDirection(CPORT, tmp & (~(csb | udb)));
+    if (latched && (pending || ud != mode))
+    {
+	out ^= udb;
+	if (!ud == mode)
+	    for (i = 0; i < npots; i++)
+	    {
+		p = pots[i];
+		if (p->latched && (mode ? p->current < 0x3f : p->current > 0))
+		    p->current += mode ? 1 : -1;
+	    }
+	return out;
+    }
+
+    if (idle && !latched)
+	out = dir ? (out | udb) : (out & ~udb);
+
+    return out;
+}
+
+/**
+ * @brief Change LCD lines of CPORT. Flags are set or unset
+ *        depending on value. Pending pot move advances in the same write.
+ * @param flags lines to change
+ * @param value true to set lines, false to clear them
+ **/
+void ControlPort::set(uint8_t flags, bool value)
+{
+    write(value ? (shadow | flags) : (shadow & (~flags)));
+}
 
-    control = iface.getOutput(CPORT);
-    iface.setOutput(CPORT, control | csb | udb);
+/**
+ * @brief Write LCD lines of CPORT. Pot lines in value are ignored,
+ *        they're driven by pending pot moves.
+ * @param value of CPORT
+ **/
+void ControlPort::write(uint8_t value)
+{
+    shadow = _next(value);
+    iface.setOutput(CPORT, shadow);
+}
 
-    for(tmp=0; tmp < 64; tmp++)
-	dec();
+/**
+ * @brief Write LCD lines of CPORT and whole DPORT
+ *        in one bus transaction. CPORT changes first.
+ * @param value of CPORT
+ * @param dport value of DPORT
+ **/
+void ControlPort::write(uint8_t value, uint8_t dport)
+{
+    shadow = _next(value);
+    iface.setOutputs(shadow, dport);
+}
 
+/**
+ * @brief Take CPORT write which caller sends in its own message,
+ *        like one encoded by lcdEncode(). Pot lines advance the
+ *        same way as with write(), so pulses ride along.
+ * @param value of CPORT
+ * @return value caller must write to CPORT
+ **/
+uint8_t ControlPort::advance(uint8_t value)
+{
+    shadow = _next(value);
+    return shadow;
+}
 
+/**
+ * @brief Finish pending pot moves with dedicated CPORT writes.
+ **/
+void ControlPort::flush()
+{
+    while (busy())
+    {
+	write(shadow);
+	nsleep(500);
+    }
+}
+
+/**
+ * @brief Check if any pot move is pending or in progress
+ * @return true if there's wiper move to do
+ **/
+bool ControlPort::busy() const
+{
+    uint8_t i;
+
+    for (i = 0; i < npots; i++)
+	if (pots[i]->moving())
+	    return true;
+    return false;
+}
+
+/**
+ * @brief Class constructor
+ *        If record with consistent wiper position is given, it's trusted
+ *        and pot is not homed, otherwise wiper is swept down to 0.
+ * @param cport control port shared by LCD and pots
+ * @param cs - line number where CS line of MCP401x is connected to
+ * @param rec - saved state of the pot or NULL
+ **/
+Potentiometer::Potentiometer(ControlPort &cport, t_PotBits cs, t_PotRecord *rec) : port(cport), current(0), target(0), csb((uint8_t) cs),
+                                                                                   latched(false), up(false), record(rec)
+{
+    uint8_t tmp;
+
+    tmp = port.chip().getDirection(CPORT);
+    port.chip().setDirection(CPORT, tmp & (~(csb | port.potmask)));
+    port.attach(this);
+
+    if (record && record->generation && !(record->generation & 1) && record->wiper < 0x40)
+    {
+	current = record->wiper;
+	target = current;
+    } else
+	home();
 }
 
 /**
@@ -48,116 +328,83 @@ Potentiometer::~Potentiometer()
     uint8_t tmp;
 
     set(0x00);
-    tmp = iface.getDirection(CPORT);
-    iface.setDirection(CPORT, tmp | csb | udb);
+    port.detach(this);
+    tmp = port.chip().getDirection(CPORT);
+    port.chip().setDirection(CPORT, tmp | csb | port.udb);
 }
 
 /**
- * @brief Set state of CS line
- * @param True for 1, False for 0
+ * @brief Check if wiper still has to move in latched direction
+ * @return true if there are pulses to send
  **/
-void Potentiometer::cs(bool value)
+bool Potentiometer::pending() const
 {
-    control = value ? (control | csb) : (control & (~csb));
-    iface.setOutput(CPORT, control);
+    uint8_t t = target.load(std::memory_order_relaxed);
+
+    return up ? t > current : t < current;
 }
 
 /**
- * @brief Set state of UD line
- * @param True for 1, False for 0
+ * @brief Mark saved wiper position as being changed
  **/
-void Potentiometer::ud(bool value)
+void Potentiometer::begin()
 {
-    control = value ? (control | udb) : (control & (~udb));
-    iface.setOutput(CPORT, control);
+    if (record)
+	record->generation |= 1;
 }
 
 /**
- * @brief Decrement current value of potentiometer by 1
+ * @brief Save current wiper position and mark it consistent
  **/
-void Potentiometer::dec()
+void Potentiometer::commit()
 {
-    current -= current > 0 ? 1 : 0;
-    ud(0);
-    nsleep(750);
-    cs(0);
-    ud(1);
-    nsleep(500);
-    ud(0);
-    usleep(5);
-    cs(1);
-    usleep(5);
+    if (record)
+    {
+	record->wiper = current;
+	record->generation++;
+    }
 }
 
 /**
- * @brief Increment current value of potentiometer by 1
+ * @brief Move wiper to known position by decrementing it 64 times.
+ *        Forces re-homing even when saved position is available.
  **/
-void Potentiometer::inc()
+void Potentiometer::home()
 {
-    current += current < 63 ? 1 : 0;
-    ud(1);
-    nsleep(750);
-    cs(0);
-    ud(0);
-    nsleep(500);
-    ud(1);
-    usleep(5);
-    cs(1);
-    usleep(5);
+    target = 0;
+    current = 64;
+    port.flush();
 }
 
 /**
- * @brief Set potentiometer to given value.
- *        Will set value of pot by calculating delta between
- *        requested value and current value and depend of sign of the delta
- *        will decrement/increment pot by one until desired value is reached.
+ * @brief Set potentiometer to given value and wait until wiper gets there.
  *        These potentiometers don't have any register we can read to get current
  *        wiper position, so we must remeber state of pot in class variable.
+ *        Other pending pot moves in the same direction are done together.
  * @param value
  **/
 void Potentiometer::set(uint8_t value)
 {
-    uint8_t diff, i;
+    post(value);
+    port.flush();
+}
 
-    value %= 0x40;
+/**
+ * @brief Request wiper move without waiting for it. Move rides along
+ *        following CPORT writes or is finished by ControlPort::flush().
+ *        Can be called from any thread.
+ * @param value
+ **/
+void Potentiometer::post(uint8_t value)
+{
+    target.store(value % 0x40, std::memory_order_relaxed);
+}
 
-    if (value > current)
-    {
-	diff = value - current;
-	ud(1);
-	nsleep(750);
-	cs(0);
-	for (i=0; i < diff; i++)
-	{
-	    ud(0);
-	    nsleep(500);
-	    ud(1);
-	    nsleep(500);
-	}
-	usleep(5);
-	cs(1);
-	if ((current + diff) > 0x3f)
-	    current = 0x3f;
-	else
-	    current += diff;
-    } else if (value < current)
-    {
-	diff = current - value;
-	ud(0);
-	nsleep(750);
-	cs(0);
-	for(i=0; i < diff; i++)
-	{
-	    ud(1);
-	    nsleep(500);
-	    ud(0);
-	    nsleep(500);
-	}
-	usleep(5);
-	cs(1);
-	if ((current - diff) < 0)
-	    current = 0;
-	else
-	    current -= diff;
-    }
+/**
+ * @brief Check if wiper move is pending or in progress
+ * @return true if wiper hasn't reached its target yet
+ **/
+bool Potentiometer::moving() const
+{
+    return latched || target.load(std::memory_order_relaxed) != current;
 }
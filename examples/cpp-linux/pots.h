@@ -2,6 +2,8 @@
 #define __POTS_H__
 
 #include <cstdint>
+#include <cstddef>
+#include <atomic>
 #include <pca9535.h>
 
 using namespace i2lcd;
@@ -14,6 +16,109 @@ enum t_PotBits {
     BACKLIGHT_CS = 1 << 7,
 };
 
+/**
+ * @brief Last commanded wiper position of one potentiometer.
+ *        Generation is incremented before and after every wiper move,
+ *        so an odd value means the move was interrupted and the wiper
+ *        position can't be trusted.
+ */
+struct t_PotRecord {
+    uint32_t generation;
+    uint8_t wiper;
+    uint8_t reserved[3];
+};
+
+/**
+ * @brief Layout of the potentiometers state file.
+ */
+struct t_PotStateFile {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t bus;
+    uint8_t address;
+    uint8_t reserved;
+    t_PotRecord pots[2];
+};
+
+#define POTSTATE_MAGIC 0x544f5032
+#define POTSTATE_VERSION 1
+
+/**
+ * @class PotState
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Persistent wiper positions of the module potentiometers.
+ *
+ * MCP401x wiper can't be read back, so without saved state every
+ * Potentiometer has to be swept down to a known position when created.
+ * PotState maps small file, named after bus and chip address, into memory
+ * and keeps last commanded wiper positions there. Use directory on tmpfs
+ * (/run or /dev/shm) so state never outlives power cycle of the host.
+ *
+ */
+class PotState
+{
+    private:
+	int fileh;
+	t_PotStateFile *state;
+
+    public:
+	PotState(const char *dir, uint8_t bus, uint8_t address);
+	~PotState();
+
+	bool valid() const { return state != NULL; };
+	t_PotRecord *record(t_PotBits csb);
+};
+
+class Potentiometer;
+
+/**
+ * @class ControlPort
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Single owner of CPORT output register shadow.
+ *
+ * LCD control lines (EN, RS, RW, PWR) and potentiometers lines (UD and
+ * both CS) share CPORT. Every CPORT write goes through this class,
+ * which merges pending wiper moves into it: while pot CS is held low,
+ * each write toggles UD, so two writes of LCD strobe move wiper by one
+ * step without any extra bus traffic. flush() sends dedicated writes
+ * when there's no LCD traffic to ride along.
+ *
+ */
+class ControlPort
+{
+    friend class Potentiometer;
+
+    private:
+	PCA9535 &iface;
+	uint8_t shadow;
+	uint8_t udb;
+	uint8_t potmask;
+	Potentiometer *pots[2];
+	uint8_t npots;
+
+	uint8_t _next(uint8_t value);
+
+    public:
+	ControlPort(PCA9535 &chip, uint8_t initial, t_PotBits ud);
+
+	void attach(Potentiometer *pot);
+	void detach(Potentiometer *pot);
+
+	void set(uint8_t flags, bool value);
+	void write(uint8_t value);
+	void write(uint8_t value, uint8_t dport);
+	uint8_t advance(uint8_t value);
+	void flush();
+	bool busy() const;
+	void assume(uint8_t value) { shadow = value; };
+	uint8_t get() const { return shadow; };
+	PCA9535 &chip() { return iface; };
+};
+
 /**
  * @class Potentiometer
  *
@@ -22,32 +127,39 @@ enum t_PotBits {
  * @brief Class for controlling potentiometers in I2LCD module.
  *        Same for backlight intensity and contrast.
  *        Module is using MCP401x chips, so this class is realization
- *        of it's up/down protocol.
+ *        of it's up/down protocol. Pulses themselves are generated by
+ *        ControlPort, Potentiometer only keeps wiper position and target.
  *
  */
 class Potentiometer
 {
+    friend class ControlPort;
+
     private:
-	uint8_t control;
+	ControlPort &port;
 	uint8_t current;
+	std::atomic<uint8_t> target;
 	uint8_t csb;
-	uint8_t udb;
-	PCA9535 &iface;
+	bool latched;
+	bool up;
+	t_PotRecord *record;
 
-	void dec();
-	void inc();
-	void ud(bool value);
-	void cs(bool value);
+	bool pending() const;
+	void begin();
+	void commit();
 
     public:
-	Potentiometer(PCA9535 &chip, t_PotBits csb, t_PotBits ud);
+	Potentiometer(ControlPort &cport, t_PotBits csb, t_PotRecord *rec = NULL);
 	~Potentiometer();
 
+	void home();
 	void set(uint8_t value);
+	void post(uint8_t value);
+	uint8_t get() const { return current; };
+	bool moving() const;
 };
 
 
-
 };
 
 
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <scheduler.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Aggregate throughput of 1, 4 and 8 displays sharing one simulated
+ * 100 kHz bus. Each round clears every 20x4 display and fills it with text.
+ * Compared are: plain I2Lcd calls one display after another, scheduler
+ * draining displays one after another, and scheduler overlapping them.
+ * Violations count strobes which arrived while HD44780 was still busy.
+ *
+ * usage: schedbench [rounds] [bus clock in Hz]
+ */
+
+static const char *text[4] = {
+    "Temperature   21.5 C",
+    "Humidity      47.0 %",
+    "Pressure   1013 hPa ",
+    "Wind         3.2 m/s",
+};
+
+static unsigned long _violations(SimBus &bus, unsigned n)
+{
+    unsigned long v = 0;
+    unsigned i;
+
+    for (i = 0; i < n; i++)
+	v += bus.module(0x20 + i).violations;
+    return v;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned rounds = argc > 1 ? atoi(argv[1]) : 3;
+    unsigned clock = argc > 2 ? atoi(argv[2]) : 100000;
+    unsigned counts[] = {1, 4, 8};
+    unsigned c, i, r, row, n;
+    double t;
+
+    printf("displays  mode        chars/s  transactions  violations\n");
+    for (c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+	SimBus bus(clock);
+	BusScheduler sched(bus);
+	std::vector<I2Lcd*> lcds;
+	double chars;
+
+	n = counts[c];
+	for (i = 0; i < n; i++)
+	{
+	    lcds.push_back(new I2Lcd(bus, 0x20 + i, D20x4));
+	    lcds[i]->power(POWERON);
+	    sched.attach(*lcds[i]);
+	}
+	chars = (double) rounds * n * 80;
+
+	bus.resetCounters();
+	steady_clock::time_point start = steady_clock::now();
+	for (r = 0; r < rounds; r++)
+	    for (i = 0; i < n; i++)
+	    {
+		lcds[i]->clear();
+		for (row = 0; row < 4; row++)
+		{
+		    lcds[i]->setCursor(0, row);
+		    lcds[i]->print(text[row]);
+		}
+	    }
+	t = duration<double>(steady_clock::now() - start).count();
+	printf("%8u  %-10s %8.1f  %12lu  %10lu\n", n, "serial", chars / t, bus.getTransactions(), _violations(bus, n));
+
+	bus.resetCounters();
+	start = steady_clock::now();
+	for (r = 0; r < rounds; r++)
+	    for (i = 0; i < n; i++)
+	    {
+		sched.clear(i);
+		for (row = 0; row < 4; row++)
+		    sched.print(i, 0, row, text[row]);
+		sched.run();
+	    }
+	t = duration<double>(steady_clock::now() - start).count();
+	printf("%8u  %-10s %8.1f  %12lu  %10lu\n", n, "sequential", chars / t, bus.getTransactions(), _violations(bus, n));
+
+	bus.resetCounters();
+	start = steady_clock::now();
+	for (r = 0; r < rounds; r++)
+	    for (i = 0; i < n; i++)
+	    {
+		sched.clear(i);
+		for (row = 0; row < 4; row++)
+		    sched.print(i, 0, row, text[row]);
+	    }
+	sched.run();
+	t = duration<double>(steady_clock::now() - start).count();
+	printf("%8u  %-10s %8.1f  %12lu  %10lu\n", n, "overlapped", chars / t, bus.getTransactions(), _violations(bus, n));
+
+	for (i = 0; i < n; i++)
+	    delete lcds[i];
+    }
+}
@@ -0,0 +1,352 @@
+#include <string.h>
+
+#include <scheduler.h>
+
+using namespace i2lcd;
+
+#define AC_CGRAM	0x100
+#define AC_UNKNOWN	0xffff
+
+/**
+ * @brief BusScheduler class constructor. Opens /dev/i2c-N
+ * and owns it, displays are created on getBus().
+ *
+ * @param busn bus number
+ **/
+BusScheduler::BusScheduler(uint8_t busn) : bus(new I2CDevBus(busn)), owner(true), next(0), issued(0), waits(0), restores(0)
+{
+}
+
+/**
+ * @brief BusScheduler class constructor for already opened bus
+ *
+ * @param busi bus interface
+ **/
+BusScheduler::BusScheduler(I2CBus &busi) : bus(&busi), owner(false), next(0), issued(0), waits(0), restores(0)
+{
+}
+
+/**
+ * @brief BusScheduler class destructor.
+ * Pending operations are dropped.
+ **/
+BusScheduler::~BusScheduler()
+{
+    if (owner)
+	delete bus;
+}
+
+/**
+ * @brief Attach display to the scheduler. Display must
+ * be created on scheduler's bus and powered on.
+ *
+ * @param lcd display
+ * @return display number used by other methods
+ **/
+unsigned BusScheduler::attach(I2Lcd &lcd)
+{
+    t_Display d;
+
+    d.lcd = &lcd;
+    d.address[PRIORITY_NORMAL] = d.address[PRIORITY_HIGH] = AC_UNKNOWN;
+    d.ac = AC_UNKNOWN;
+    d.readyat = 0;
+    displays.push_back(d);
+    return displays.size() - 1;
+}
+
+/**
+ * @brief Queue command
+ *
+ * @param display number
+ * @param command
+ * @param value command arguments
+ **/
+void BusScheduler::command(unsigned display, t_Command command, uint8_t value, t_Priority priority)
+{
+    t_LcdOp op = {false, (uint8_t) (value | (1 << (uint8_t) command))};
+
+    displays[display].queue[priority].push_back(op);
+}
+
+/**
+ * @brief Queue data bytes, written at current address
+ *
+ * @param display number
+ * @param data bytes
+ * @param len number of bytes
+ * @param priority lane
+ **/
+void BusScheduler::write(unsigned display, const char *data, unsigned len, t_Priority priority)
+{
+    t_LcdOp op = {true, 0};
+    unsigned i;
+
+    for (i = 0; i < len; i++)
+    {
+	op.value = data[i];
+	displays[display].queue[priority].push_back(op);
+    }
+}
+
+/**
+ * @brief Queue string at given position. Text continues
+ * in the next row when it doesn't fit, '\\n' starts
+ * next row, as in I2Lcd::print().
+ *
+ * @param display number
+ * @param column
+ * @param row
+ * @param text
+ * @param priority lane
+ **/
+void BusScheduler::print(unsigned display, uint8_t column, uint8_t row, const string &text, t_Priority priority)
+{
+    const LcdType &type = displays[display].lcd->type();
+    bool address = true;
+    size_t i;
+
+    for (i = 0; i < text.size(); i++)
+    {
+	if (text[i] == '\n')
+	{
+	    row = (row + 1) % type.getRows();
+	    column = 0;
+	    address = true;
+	    continue;
+	}
+	if (address)
+	{
+	    command(display, SET_DDRAM_ADDRESS, type.ddAddress(column, row), priority);
+	    address = false;
+	}
+	write(display, &text[i], 1, priority);
+	displays[display].lcd->getScreen().put(column, row, text[i]);
+	if (++column == type.getColumns())
+	{
+	    row = (row + 1) % type.getRows();
+	    column = 0;
+	    address = true;
+	}
+    }
+}
+
+/**
+ * @brief Queue display clear
+ *
+ * @param display number
+ * @param priority lane
+ **/
+void BusScheduler::clear(unsigned display, t_Priority priority)
+{
+    command(display, CLEAR_DISPLAY, 0x00, priority);
+    displays[display].lcd->getScreen().clear();
+}
+
+/**
+ * @brief Queue return home
+ *
+ * @param display number
+ * @param priority lane
+ **/
+void BusScheduler::home(unsigned display, t_Priority priority)
+{
+    command(display, CURSOR_HOME, 0x00, priority);
+}
+
+/**
+ * @brief Queue operations changing display content to given
+ * frame. Only changed cells and glyph bytes are queued.
+ *
+ * @param display number
+ * @param frame to show
+ * @param priority lane
+ **/
+void BusScheduler::show(unsigned display, const FrameBuffer &frame, t_Priority priority)
+{
+    t_Display &d = displays[display];
+    size_t i;
+
+    ops.clear();
+    d.lcd->getScreen().update(frame, d.lcd->type(), ops);
+    for (i = 0; i < ops.size(); i++)
+	d.queue[priority].push_back(ops[i]);
+}
+
+/**
+ * @brief Check if any operation is waiting
+ *
+ * @return true if there's work to do
+ **/
+bool BusScheduler::pending(void) const
+{
+    size_t i;
+
+    for (i = 0; i < displays.size(); i++)
+	if (_lane(displays[i]) >= 0)
+	    return true;
+    return false;
+}
+
+/**
+ * @brief Check if lane of a display has operations waiting
+ *
+ * @param display number
+ * @param priority lane
+ * @return true if lane isn't drained yet
+ **/
+bool BusScheduler::pending(unsigned display, t_Priority priority) const
+{
+    return !displays[display].queue[priority].empty();
+}
+
+/**
+ * @brief Helper returning highest lane with pending work, -1 if none
+ **/
+int BusScheduler::_lane(const t_Display &d) const
+{
+    int lane;
+
+    for (lane = PRIORITIES - 1; lane >= 0; lane--)
+	if (!d.queue[lane].empty())
+	    return lane;
+    return -1;
+}
+
+/**
+ * @brief Helper returning address counter after operation. Displays
+ * are set to increment, 2-line DDRAM wraps from 0x27 to 0x40.
+ **/
+uint16_t BusScheduler::_advance(uint16_t ac, const t_LcdOp &op)
+{
+    if (!op.rs)
+    {
+	if (op.value & (1 << SET_DDRAM_ADDRESS))
+	    return op.value & 0x7f;
+	if (op.value & (1 << SET_CGRAM_ADDRESS))
+	    return AC_CGRAM | (op.value & 0x3f);
+	if (op.value <= ((1 << CURSOR_HOME) | 1))
+	    return 0;
+	return ac;
+    }
+    if (ac == AC_UNKNOWN)
+	return ac;
+    if (ac & AC_CGRAM)
+	return AC_CGRAM | ((ac + 1) & 0x3f);
+    if (ac == 0x27)
+	return 0x40;
+    if (ac == 0x67)
+	return 0x00;
+    return ac + 1;
+}
+
+/**
+ * @brief Helper putting issued data byte into display's screen copy,
+ * so when lanes overlap the copy ends with what was issued last
+ **/
+void BusScheduler::_record(t_Display &d, uint16_t ac, uint8_t value)
+{
+    FrameBuffer &screen = d.lcd->getScreen();
+    const LcdType &type = d.lcd->type();
+    char glyph[8];
+    uint8_t row, base;
+
+    if (ac & AC_CGRAM)
+    {
+	memcpy(glyph, screen.glyph((ac >> 3) & 0x07), sizeof(glyph));
+	glyph[ac & 0x07] = value;
+	screen.setGC((ac >> 3) & 0x07, glyph);
+	return;
+    }
+    for (row = 0; row < type.getRows(); row++)
+    {
+	base = type.ddAddress(0, row);
+	if (ac >= base && ac < base + type.getColumns())
+	{
+	    screen.put(ac - base, row, value);
+	    return;
+	}
+    }
+}
+
+/**
+ * @brief Helper issuing next operation of the lane. When other lane
+ * moved address counter since, address is set back first.
+ **/
+void BusScheduler::_issue(t_Display &d, int lane)
+{
+    t_LcdOp op = d.queue[lane].front();
+    uint16_t a = d.address[lane];
+
+    if (op.rs && a != AC_UNKNOWN && a != d.ac)
+    {
+	op.rs = false;
+	op.value = (a & AC_CGRAM) ? ((1 << SET_CGRAM_ADDRESS) | (a & 0x3f)) : ((1 << SET_DDRAM_ADDRESS) | a);
+	restores++;
+    } else
+	d.queue[lane].pop_front();
+
+    d.lcd->strobe(op.rs, op.value);
+    if (op.rs && d.ac != AC_UNKNOWN)
+	_record(d, d.ac, op.value);
+    d.readyat = monotonicNs() + (uint64_t) I2Lcd::execTime(op.rs, op.value) * 1000;
+    d.ac = d.address[lane] = _advance(d.ac, op);
+    issued++;
+}
+
+/**
+ * @brief Issue next operation. Highest lane with pending work is
+ * served first, displays within lane go in round robin order. Busy
+ * displays are skipped.
+ *
+ * @return true if operation was issued, false if every display
+ *         with pending work is still busy
+ **/
+bool BusScheduler::step(void)
+{
+    uint64_t now = monotonicNs();
+    size_t i, n = displays.size();
+    t_Display *d;
+    int lane;
+
+    for (lane = PRIORITIES - 1; lane >= 0; lane--)
+	for (i = 0; i < n; i++)
+	{
+	    d = &displays[(next + i) % n];
+	    if (_lane(*d) != lane || d->readyat > now)
+		continue;
+
+	    _issue(*d, lane);
+	    next = (next + i + 1) % n;
+	    return true;
+	}
+    return false;
+}
+
+/**
+ * @brief Sleep until first busy display with pending work is ready.
+ **/
+void BusScheduler::wait(void)
+{
+    uint64_t t = 0;
+    size_t i;
+
+    for (i = 0; i < displays.size(); i++)
+	if (_lane(displays[i]) >= 0 && (!t || displays[i].readyat < t))
+	    t = displays[i].readyat;
+    if (!t)
+	return;
+
+    sleepUntil(t);
+    waits++;
+}
+
+/**
+ * @brief Issue all queued operations
+ **/
+void BusScheduler::run(void)
+{
+    while (pending())
+	if (!step())
+	    wait();
+}
@@ -0,0 +1,103 @@
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+#include <cstdint>
+#include <string>
+#include <deque>
+#include <vector>
+
+#include <i2lcd.h>
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+/**
+ * @brief Scheduler lanes, higher lane is served first
+ */
+enum t_Priority {
+    PRIORITY_NORMAL,
+    PRIORITY_HIGH,
+    PRIORITIES,
+};
+
+/**
+ * @class BusScheduler
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Scheduler multiplexing many I2LCD modules on one I2C bus.
+ *
+ * Scheduler owns the bus and keeps queue of HD44780 operations for every
+ * attached display. Instead of polling busy flag, it knows how long each
+ * operation executes and issues operations of other displays meanwhile,
+ * so while display A executes 1.52 ms clear, display B gets its text.
+ * Bus only idles when every display with pending work is busy.
+ *
+ * While display is attached, its content should only be changed through
+ * the scheduler, as I2Lcd cursor state isn't updated by queued operations.
+ * Display's screen copy is updated when operations are queued, so show()
+ * only sends what changed.
+ *
+ * Every display has a queue per priority lane. Operations of higher lane
+ * go out at the next HD44780 operation boundary, lower lane resumes when
+ * higher one drains. Scheduler follows address counter of every lane and
+ * sets it back before data of interrupted lane continue, so background
+ * redraw ends where it would without the interruption. Cells written
+ * by both lanes end with what was issued last, screen copy follows that.
+ *
+ */
+class BusScheduler
+{
+    private:
+	struct t_Display {
+	    I2Lcd *lcd;
+	    std::deque<t_LcdOp> queue[PRIORITIES];
+	    uint16_t address[PRIORITIES];
+	    uint16_t ac;
+	    uint64_t readyat;
+	};
+
+	I2CBus *bus;
+	bool owner;
+	std::vector<t_Display> displays;
+	std::vector<t_LcdOp> ops;
+	unsigned next;
+	unsigned long issued;
+	unsigned long waits;
+	unsigned long restores;
+
+	int _lane(const t_Display &d) const;
+	void _issue(t_Display &d, int lane);
+	void _record(t_Display &d, uint16_t ac, uint8_t value);
+	static uint16_t _advance(uint16_t ac, const t_LcdOp &op);
+
+    public:
+	BusScheduler(uint8_t busn);
+	BusScheduler(I2CBus &busi);
+	~BusScheduler();
+
+	I2CBus &getBus(void) { return *bus; };
+	unsigned attach(I2Lcd &lcd);
+	I2Lcd &display(unsigned display) { return *displays[display].lcd; };
+
+	void command(unsigned display, t_Command command, uint8_t value, t_Priority priority = PRIORITY_NORMAL);
+	void write(unsigned display, const char *data, unsigned len, t_Priority priority = PRIORITY_NORMAL);
+	void print(unsigned display, uint8_t column, uint8_t row, const string &text, t_Priority priority = PRIORITY_NORMAL);
+	void clear(unsigned display, t_Priority priority = PRIORITY_NORMAL);
+	void home(unsigned display, t_Priority priority = PRIORITY_NORMAL);
+	void show(unsigned display, const FrameBuffer &frame, t_Priority priority = PRIORITY_NORMAL);
+
+	bool pending(void) const;
+	bool pending(unsigned display, t_Priority priority) const;
+	bool step(void);
+	void wait(void);
+	void run(void);
+
+	unsigned long getIssued(void) const { return issued; };
+	unsigned long getWaits(void) const { return waits; };
+	unsigned long getRestores(void) const { return restores; };
+};
+
+};
+
+#endif
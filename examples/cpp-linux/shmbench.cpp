@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <shmframe.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Producer writing counters into shared memory frame as fast as it can,
+ * while ShmFlusher sends changes of 20x4 display on simulated 100 kHz bus
+ * every 20 ms. Producer maps segment by name, as other process would.
+ * At the end display content is compared with the last frame written.
+ *
+ * usage: shmbench [seconds]
+ */
+
+int main(int argc, char **argv)
+{
+    unsigned seconds = argc > 1 ? atoi(argv[1]) : 2;
+    unsigned long writes = 0;
+    unsigned row, bad = 0;
+    char line[24];
+    double t;
+    SimBus bus(100000);
+    I2Lcd lcd(bus, 0x20, D20x4);
+
+    lcd.power(POWERON);
+    {
+	ShmFrame owner("/i2lcd-shmbench", 20, 4);
+	ShmFrame producer("/i2lcd-shmbench");
+
+	{
+	    ShmFlusher flusher(owner, lcd, 20);
+
+	    steady_clock::time_point start = steady_clock::now();
+	    do {
+		for (row = 0; row < 4; row++)
+		{
+		    snprintf(line, sizeof(line), "row %u count %8lu", row, writes);
+		    producer.write(0, row, line);
+		}
+		writes++;
+	    } while (duration<double>(steady_clock::now() - start).count() < seconds);
+	    t = duration<double>(steady_clock::now() - start).count();
+	    printf("frames written: %lu, %.1f ns per row write, flushes: %lu\n",
+		writes, t * 1e9 / writes / 4, flusher.getFlushes());
+	}
+
+	for (row = 0; row < 4; row++)
+	{
+	    snprintf(line, sizeof(line), "row %u count %8lu", row, writes - 1);
+	    if (bus.visible(0x20, D20x4, row) != line)
+		bad++;
+	}
+	printf("rows differing from last frame: %u, violations: %lu\n", bad, bus.module(0x20).violations);
+    }
+}
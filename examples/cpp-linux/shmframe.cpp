@@ -0,0 +1,335 @@
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+#include <shmframe.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief ShmFrame class constructor creating the segment.
+ * Frame is filled with spaces and empty glyphs.
+ *
+ * @param shmname POSIX shared memory name, like "/i2lcd-1-20"
+ * @param columns
+ * @param rows
+ **/
+ShmFrame::ShmFrame(const char *shmname, uint8_t columns, uint8_t rows) : shm(NULL), name(shmname), owner(true)
+{
+    int fd;
+
+    fd = shm_open(shmname, O_RDWR | O_CREAT | O_CLOEXEC, 0660);
+    if (fd < 0 || ftruncate(fd, sizeof(t_ShmFrame)) < 0)
+    {
+	if (fd >= 0)
+	    close(fd);
+	throw tShmOpen;
+    }
+    _map(fd);
+
+    shm->magic = SHMFRAME_MAGIC;
+    shm->version = SHMFRAME_VERSION;
+    shm->columns = columns < FB_MAX_COLUMNS ? columns : FB_MAX_COLUMNS;
+    shm->rows = rows < FB_MAX_ROWS ? rows : FB_MAX_ROWS;
+    shm->sequence = 0;
+    shm->writer = 0;
+    memset(shm->cells, ' ', sizeof(shm->cells));
+    memset(shm->glyphs, 0, sizeof(shm->glyphs));
+    shm->dirty = SHMFRAME_GLYPHS | ((1 << shm->rows) - 1);
+}
+
+/**
+ * @brief ShmFrame class constructor opening segment created
+ * by another process.
+ *
+ * @param shmname POSIX shared memory name
+ **/
+ShmFrame::ShmFrame(const char *shmname) : shm(NULL), name(shmname), owner(false)
+{
+    int fd;
+
+    fd = shm_open(shmname, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+	throw tShmOpen;
+    _map(fd);
+    if (shm->magic != SHMFRAME_MAGIC || shm->version != SHMFRAME_VERSION)
+    {
+	munmap(shm, sizeof(t_ShmFrame));
+	throw tShmOpen;
+    }
+}
+
+/**
+ * @brief ShmFrame class destructor. Creator also removes the name.
+ **/
+ShmFrame::~ShmFrame()
+{
+    munmap(shm, sizeof(t_ShmFrame));
+    if (owner)
+	shm_unlink(name.c_str());
+}
+
+/**
+ * @brief Helper mapping opened segment. This method is private
+ **/
+void ShmFrame::_map(int fd)
+{
+    void *p;
+
+    p = mmap(NULL, sizeof(t_ShmFrame), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+	throw tShmOpen;
+    shm = (t_ShmFrame *) p;
+}
+
+/**
+ * @brief Helper backing off while lock is held: spin first, then
+ * yield, then sleep. This method is private
+ *
+ * @param tries number of attempts so far
+ **/
+void ShmFrame::_backoff(unsigned tries)
+{
+    struct timespec ts = {0, 50000};
+
+    if (tries < 64)
+	return;
+    if (tries < 128)
+	sched_yield();
+    else
+	nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Helper taking over lock of writer which died holding it.
+ * Pid in writer word is only replaced when kill() reports it gone,
+ * and only one caller can win that exchange. The winner makes
+ * sequence odd if the dead writer didn't, and marks everything
+ * dirty, as rows may be half written. This method is private
+ *
+ * @return true if the caller holds the lock now
+ **/
+bool ShmFrame::_takeover(void)
+{
+    int32_t pid = shm->writer.load(std::memory_order_acquire);
+
+    if (!pid || kill(pid, 0) == 0 || errno != ESRCH)
+	return false;
+    if (!shm->writer.compare_exchange_strong(pid, getpid(), std::memory_order_acquire))
+	return false;
+    if (!(shm->sequence.load(std::memory_order_relaxed) & 1))
+	shm->sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    shm->dirty.fetch_or(SHMFRAME_GLYPHS | ((1 << shm->rows) - 1), std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Start writing. Waits while other writer holds the lock,
+ * never waits for the bus. Lock of dead writer is taken over.
+ **/
+void ShmFrame::begin(void)
+{
+    int32_t none, self = getpid();
+    unsigned tries;
+
+    for (tries = 0; ; tries++)
+    {
+	none = 0;
+	if (shm->writer.compare_exchange_weak(none, self, std::memory_order_acquire))
+	{
+	    shm->sequence.fetch_add(1, std::memory_order_relaxed);
+	    break;
+	}
+	if (tries >= 128 && _takeover())
+	    return;
+	_backoff(tries);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief Finish writing started by begin()
+ **/
+void ShmFrame::end(void)
+{
+    shm->sequence.fetch_add(1, std::memory_order_release);
+    shm->writer.store(0, std::memory_order_release);
+}
+
+/**
+ * @brief Put characters, clipped at the end of the row.
+ * Must be called between begin() and end().
+ *
+ * @param column
+ * @param row
+ * @param text characters
+ * @param len number of characters
+ **/
+void ShmFrame::put(uint8_t column, uint8_t row, const char *text, unsigned len)
+{
+    if (row >= shm->rows || column >= shm->columns)
+	return;
+    if (len > (unsigned) (shm->columns - column))
+	len = shm->columns - column;
+    if (memcmp(&shm->cells[row][column], text, len))
+    {
+	memcpy(&shm->cells[row][column], text, len);
+	shm->dirty.fetch_or(1 << row, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Define user character. Must be called between
+ * begin() and end().
+ *
+ * @param character number 0-7
+ * @param bitmap 8 bytes, one per glyph row
+ **/
+void ShmFrame::setGC(uint8_t character, const char *bitmap)
+{
+    if (memcmp(shm->glyphs[character & 0x07], bitmap, 8))
+    {
+	memcpy(shm->glyphs[character & 0x07], bitmap, 8);
+	shm->dirty.fetch_or(SHMFRAME_GLYPHS, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Write text at given position under the lock
+ *
+ * @param column
+ * @param row
+ * @param text
+ **/
+void ShmFrame::write(uint8_t column, uint8_t row, const string &text)
+{
+    begin();
+    put(column, row, text.data(), text.size());
+    end();
+}
+
+/**
+ * @brief Copy dirty rows and glyphs into frame. Dirty bits are taken
+ * before copying, so anything written meanwhile stays dirty for the
+ * next snapshot. Copy is retried while writer was active, up to
+ * SHMFRAME_TRIES times, then lock of a dead writer is released.
+ * Should be called from one thread only.
+ *
+ * @param frame destination, of the same size as segment
+ * @return dirty bits of copied content, 0 if nothing changed or
+ *         writer held the lock all the time
+ **/
+uint32_t ShmFrame::snapshot(FrameBuffer &frame)
+{
+    uint32_t s, d;
+    unsigned tries;
+    uint8_t r, g;
+
+    for (tries = 0; tries < SHMFRAME_TRIES; tries++)
+    {
+	s = shm->sequence.load(std::memory_order_acquire);
+	if (s & 1)
+	{
+	    _backoff(tries);
+	    continue;
+	}
+	d = shm->dirty.exchange(0, std::memory_order_acquire);
+	if (!d)
+	    return 0;
+	for (r = 0; r < shm->rows && r < frame.rows(); r++)
+	    if (d & (1 << r))
+		memcpy(frame.row(r), shm->cells[r], frame.columns() < shm->columns ? frame.columns() : shm->columns);
+	if (d & SHMFRAME_GLYPHS)
+	    for (g = 0; g < 8; g++)
+		frame.setGC(g, shm->glyphs[g]);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (shm->sequence.load(std::memory_order_relaxed) == s)
+	    return d;
+	shm->dirty.fetch_or(d, std::memory_order_relaxed);
+	_backoff(tries);
+    }
+    if (_takeover())
+	end();
+    return 0;
+}
+
+/**
+ * @brief ShmFlusher class constructor, starts flush thread
+ *
+ * @param frame shared frame
+ * @param display display, should only be written by the flusher
+ * @param refreshms refresh period in milliseconds
+ **/
+ShmFlusher::ShmFlusher(ShmFrame &frame, I2Lcd &display, unsigned refreshms) : shm(frame), lcd(display),
+    frame(display.getScreen()), flushes(0)
+{
+    struct itimerspec its;
+
+    if (!refreshms)
+	refreshms = 1;
+    timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    wakefd = eventfd(0, EFD_CLOEXEC);
+    its.it_interval.tv_sec = refreshms / 1000;
+    its.it_interval.tv_nsec = (refreshms % 1000) * 1000000;
+    its.it_value = its.it_interval;
+    timerfd_settime(timerfd, 0, &its, NULL);
+    worker = std::thread(&ShmFlusher::_run, this);
+}
+
+/**
+ * @brief ShmFlusher class destructor. Last changes are flushed
+ * before thread exits.
+ **/
+ShmFlusher::~ShmFlusher()
+{
+    uint64_t v = 1;
+
+    if (::write(wakefd, &v, sizeof(v)) < 0) {};
+    worker.join();
+    close(timerfd);
+    close(wakefd);
+}
+
+/**
+ * @brief Flush thread loop. Level changes posted to the display
+ * are finished on every tick. This method is private
+ **/
+void ShmFlusher::_run(void)
+{
+    struct pollfd fds[2];
+    bool quit = false;
+    uint64_t v;
+
+    fds[0].fd = timerfd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakefd;
+    fds[1].events = POLLIN;
+
+    while (!quit)
+    {
+	if (poll(fds, 2, -1) < 0)
+	    continue;
+	if (fds[0].revents & POLLIN)
+	    if (read(timerfd, &v, sizeof(v)) < 0) {};
+	if (fds[1].revents & POLLIN)
+	    quit = true;
+
+	if (shm.snapshot(frame))
+	{
+	    lcd.show(frame);
+	    flushes++;
+	}
+	lcd.flushLevels();
+    }
+}
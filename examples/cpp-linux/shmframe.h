@@ -0,0 +1,133 @@
+#ifndef __SHMFRAME_H__
+#define __SHMFRAME_H__
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#include <i2lcd.h>
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+#define SHMFRAME_MAGIC		0x4d48534c
+#define SHMFRAME_VERSION	2
+#define SHMFRAME_GLYPHS		(1 << 31)
+#define SHMFRAME_TRIES		200
+
+/**
+ * @brief Layout of shared memory segment. Writer holds pid of the
+ * process writing, or 0. It is taken first, then sequence is made
+ * odd; end of write makes sequence even and then clears writer.
+ * Dirty has bit per changed row and SHMFRAME_GLYPHS bit when any
+ * glyph changed.
+ */
+struct t_ShmFrame {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t columns;
+    uint8_t rows;
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> dirty;
+    std::atomic<int32_t> writer;
+    char cells[FB_MAX_ROWS][FB_MAX_COLUMNS];
+    char glyphs[8][8];
+};
+
+/**
+ * @class ShmOpen
+ *
+ * @ingroup i2lcd
+ *
+ * @brief ShmOpen Exception class thrown when shared memory segment
+ *        can't be created, opened or doesn't hold a frame
+ *
+ *
+ */
+class ShmOpen: public exception
+{
+} tShmOpen;
+
+/**
+ * @class ShmFrame
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Display content in POSIX shared memory, guarded by seqlock.
+ *
+ * Producers map the segment and write cells and glyphs directly, no
+ * syscall and no bus access is involved. Writers take the writer word
+ * with their pid, which serializes writers of different processes, make
+ * sequence odd for readers and mark rows they changed dirty. ShmFlusher
+ * reads dirty rows consistently and sends them to display.
+ *
+ * Waiting for the lock backs off to sched_yield() and short sleeps.
+ * snapshot() gives up after SHMFRAME_TRIES and leaves the rows dirty for
+ * the next call. Lock of a process which died holding it is taken over
+ * by begin() or snapshot() of another one, only once kill() reports the
+ * pid gone, and whole frame is marked dirty. A writer which is merely
+ * slow is always waited for, so begin() waits as long as a living writer
+ * holds the lock.
+ *
+ */
+class ShmFrame
+{
+    private:
+	t_ShmFrame *shm;
+	string name;
+	bool owner;
+
+	void _map(int fd);
+	bool _takeover(void);
+	static void _backoff(unsigned tries);
+
+    public:
+	ShmFrame(const char *shmname, uint8_t columns, uint8_t rows);
+	ShmFrame(const char *shmname);
+	~ShmFrame();
+
+	const string &getName(void) const { return name; };
+	uint8_t columns(void) const { return shm->columns; };
+	uint8_t rows(void) const { return shm->rows; };
+
+	void begin(void);
+	void end(void);
+	void put(uint8_t column, uint8_t row, const char *text, unsigned len);
+	void setGC(uint8_t character, const char *bitmap);
+	void write(uint8_t column, uint8_t row, const string &text);
+
+	uint32_t snapshot(FrameBuffer &frame);
+};
+
+/**
+ * @class ShmFlusher
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Thread pushing changes of ShmFrame to display at refresh rate.
+ *
+ */
+class ShmFlusher
+{
+    private:
+	ShmFrame &shm;
+	I2Lcd &lcd;
+	FrameBuffer frame;
+	std::atomic<unsigned long> flushes;
+	int timerfd;
+	int wakefd;
+	std::thread worker;
+
+	void _run(void);
+
+    public:
+	ShmFlusher(ShmFrame &frame, I2Lcd &display, unsigned refreshms = 20);
+	~ShmFlusher();
+
+	unsigned long getFlushes(void) const { return flushes; };
+};
+
+};
+
+#endif
@@ -0,0 +1,312 @@
+#include <cstring>
+
+#include <simbus.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief SimBus class constructor
+ * @param clockhz bus clock used to model wire time, 0 for no delays
+ * @param busn bus number reported to users of the bus
+ **/
+SimBus::SimBus(unsigned clockhz, uint8_t busn) : I2CBus(busn), clock(clockhz), busfree(0)
+{
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+	memset(&modules[i], 0, sizeof(t_SimModule));
+	modules[i].regs[OUTPUT0] = 0xff;
+	modules[i].regs[OUTPUT1] = 0xff;
+	modules[i].regs[CONFIG0] = 0xff;
+	modules[i].regs[CONFIG1] = 0xff;
+	modules[i].wiper[0] = modules[i].wiper[1] = 0x1f;
+	_reset(modules[i]);
+    }
+    resetCounters();
+}
+
+/**
+ * @brief Reset counters of transfers
+ **/
+void SimBus::resetCounters(void)
+{
+    uint8_t i;
+
+    transactions = 0;
+    messages = 0;
+    bytes = 0;
+    wiretime = 0;
+    for (i = 0; i < 8; i++)
+	modules[i].commands = modules[i].data = modules[i].violations = 0;
+}
+
+/**
+ * @brief Power up state of HD44780
+ * This method is private
+ **/
+void SimBus::_reset(t_SimModule &m)
+{
+    memset(m.ddram, ' ', sizeof(m.ddram));
+    memset(m.cgram, 0, sizeof(m.cgram));
+    m.ac = 0;
+    m.cgmode = false;
+    m.increment = true;
+    m.twolines = false;
+    m.shift = 0;
+    m.onoff = 0;
+    m.busyuntil = 0;
+}
+
+/**
+ * @brief Move address counter after data transfer
+ * This method is private
+ **/
+void SimBus::_advance(t_SimModule &m)
+{
+    if (m.cgmode)
+    {
+	m.ac = (m.ac + (m.increment ? 1 : -1)) & 0x3f;
+	return;
+    }
+    if (m.increment)
+    {
+	m.ac++;
+	if (m.twolines && m.ac == 0x28)
+	    m.ac = 0x40;
+	else if (m.twolines && m.ac == 0x68)
+	    m.ac = 0x00;
+	else if (!m.twolines && m.ac == 0x50)
+	    m.ac = 0x00;
+    } else
+    {
+	if (m.twolines && m.ac == 0x40)
+	    m.ac = 0x27;
+	else if (m.ac == 0x00)
+	    m.ac = m.twolines ? 0x67 : 0x4f;
+	else
+	    m.ac--;
+    }
+}
+
+/**
+ * @brief Execute HD44780 command or data write
+ * This method is private
+ **/
+void SimBus::_execute(t_SimModule &m, bool rs, uint8_t value)
+{
+    uint64_t now = monotonicNs();
+    unsigned us = 37;
+
+    if (now < m.busyuntil)
+    {
+	m.violations++;
+	return;
+    }
+
+    if (rs)
+    {
+	if (m.cgmode)
+	    m.cgram[m.ac & 0x3f] = value;
+	else
+	    m.ddram[m.ac & 0x7f] = value;
+	_advance(m);
+	m.data++;
+	us = 41;
+    } else
+    {
+	m.commands++;
+	if (value & 0x80)
+	{
+	    m.ac = value & 0x7f;
+	    m.cgmode = false;
+	} else if (value & 0x40)
+	{
+	    m.ac = value & 0x3f;
+	    m.cgmode = true;
+	} else if (value & 0x20)
+	    m.twolines = value & FS_N;
+	else if (value & 0x10)
+	{
+	    if (value & CDS_SC)
+		m.shift += (value & CDS_RL) ? -1 : 1;
+	    else if (value & CDS_RL)
+		_advance(m);
+	    m.shift %= m.twolines ? 40 : 80;
+	} else if (value & 0x08)
+	    m.onoff = value;
+	else if (value & 0x04)
+	    m.increment = value & EMS_ID;
+	else if (value & 0x02)
+	{
+	    m.ac = 0;
+	    m.cgmode = false;
+	    m.shift = 0;
+	    us = 1520;
+	} else if (value & 0x01)
+	{
+	    memset(m.ddram, ' ', sizeof(m.ddram));
+	    m.ac = 0;
+	    m.cgmode = false;
+	    m.shift = 0;
+	    m.increment = true;
+	    us = 1520;
+	}
+    }
+    m.busyuntil = monotonicNs() + us * 1000;
+}
+
+/**
+ * @brief Follow MCP401x protocol on pots lines
+ * This method is private
+ **/
+void SimBus::_pots(t_SimModule &m, uint8_t old, uint8_t value)
+{
+    bool udold = old & UD, udnew = value & UD;
+    uint8_t i, cs;
+
+    for (i = 0; i < 2; i++)
+    {
+	cs = i ? BACKLIGHT_CS : CONTRAST_CS;
+	if (m.latched[i] && !(value & cs) && udold != udnew && udnew == m.up[i])
+	{
+	    if (m.up[i] && m.wiper[i] < 0x3f)
+		m.wiper[i]++;
+	    else if (!m.up[i] && m.wiper[i] > 0)
+		m.wiper[i]--;
+	}
+	if ((old & cs) && !(value & cs))
+	{
+	    m.latched[i] = true;
+	    m.up[i] = udold;
+	}
+	if (!(old & cs) && (value & cs))
+	    m.latched[i] = false;
+    }
+}
+
+/**
+ * @brief Follow changes of CPORT outputs
+ * This method is private
+ **/
+void SimBus::_control(t_SimModule &m, uint8_t old, uint8_t value)
+{
+    _pots(m, old, value);
+
+    if (!(old & PWR) && (value & PWR))
+	_reset(m);
+    if (!(value & PWR))
+	return;
+
+    /* RS and RW are sampled while EN is high, they may drop with EN */
+    if ((old & EN) && !(value & EN))
+    {
+	if (!(old & RW))
+	    _execute(m, old & RS, m.regs[OUTPUT1]);
+	else if (old & RS)
+	    _advance(m);
+    }
+}
+
+/**
+ * @brief Write PCA9535 register
+ * This method is private
+ **/
+void SimBus::_write(t_SimModule &m, uint8_t reg, uint8_t value)
+{
+    uint8_t old = m.regs[reg];
+
+    m.regs[reg] = value;
+    if (reg == OUTPUT0)
+	_control(m, old, value);
+}
+
+/**
+ * @brief Read PCA9535 register
+ * This method is private
+ **/
+uint8_t SimBus::_read(t_SimModule &m, uint8_t reg)
+{
+    uint8_t c = m.regs[OUTPUT0];
+
+    if (reg == INPUT0)
+	return c;
+    if (reg != INPUT1)
+	return m.regs[reg];
+
+    if (!(c & PWR) || !(c & EN) || !(c & RW) || m.regs[CONFIG1] != 0xff)
+	return m.regs[OUTPUT1];
+    if (!(c & RS))
+	return (monotonicNs() < m.busyuntil ? BUSY_FLAG : 0) | (m.ac & 0x7f);
+    return m.cgmode ? m.cgram[m.ac & 0x3f] : m.ddram[m.ac & 0x7f];
+}
+
+/**
+ * @brief Transfer messages. Only addresses 0x20-0x27 answer.
+ * @param msgs array of messages
+ * @param count number of messages
+ * @return number of messages transferred or -1 on error
+ **/
+int SimBus::transfer(struct i2c_msg *msgs, unsigned count)
+{
+    uint64_t t, now;
+    unsigned i, j, bits = 0;
+
+    for (i = 0; i < count; i++)
+    {
+	if ((msgs[i].addr & 0x78) != 0x20)
+	    return -1;
+
+	t_SimModule &m = modules[msgs[i].addr & 0x07];
+	for (j = 0; j < msgs[i].len; j++)
+	{
+	    if (msgs[i].flags & I2C_M_RD)
+		msgs[i].buf[j] = _read(m, m.pointer);
+	    else if (j == 0)
+	    {
+		m.pointer = msgs[i].buf[0] & 0x07;
+		continue;
+	    } else
+		_write(m, m.pointer, msgs[i].buf[j]);
+	    if (j || (msgs[i].flags & I2C_M_RD))
+		m.pointer ^= 1;
+	}
+	bits += 9 * (1 + msgs[i].len) + 1;
+	bytes += 1 + msgs[i].len;
+    }
+    transactions++;
+    messages += count;
+
+    if (clock)
+    {
+	t = (uint64_t) (bits + 1) * 1000000000 / clock;
+	wiretime += t;
+	now = monotonicNs();
+	busfree = (busfree > now ? busfree : now) + t;
+	sleepUntil(busfree);
+    }
+    return count;
+}
+
+/**
+ * @brief Return characters visible in given row of simulated LCD,
+ *        taking display shift into account.
+ * @param address module address
+ * @param type LCD type connected to the module
+ * @param row number
+ * @return row content
+ **/
+std::string SimBus::visible(uint8_t address, const LcdType &type, uint8_t row) const
+{
+    const t_SimModule &m = modules[address & 0x07];
+    uint8_t base = type[row];
+    int len = m.twolines ? 40 : 80;
+    int line = m.twolines ? (base & 0x40) : 0;
+    int offset = base - line;
+    std::string s;
+    uint8_t c;
+
+    for (c = 0; c < type.getColumns(); c++)
+	s += (char) m.ddram[line + (((offset + c + m.shift) % len) + len) % len];
+    return s;
+}
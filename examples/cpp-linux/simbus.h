@@ -0,0 +1,85 @@
+#ifndef __SIMBUS_H__
+#define __SIMBUS_H__
+
+#include <cstdint>
+#include <string>
+
+#include <i2lcd.h>
+
+namespace i2lcd {
+
+/**
+ * @brief State of one simulated I2LCD module:
+ *        PCA9535 registers, HD44780 memories and MCP401x wipers.
+ */
+struct t_SimModule {
+    uint8_t regs[8];
+    uint8_t pointer;
+    uint8_t ddram[128];
+    uint8_t cgram[64];
+    uint8_t ac;
+    bool cgmode;
+    bool increment;
+    bool twolines;
+    int8_t shift;
+    uint8_t onoff;
+    uint64_t busyuntil;
+    uint8_t wiper[2];
+    bool latched[2];
+    bool up[2];
+    unsigned long commands;
+    unsigned long data;
+    unsigned long violations;
+};
+
+/**
+ * @class SimBus
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Simulated I2C bus with I2LCD modules at addresses 0x20-0x27
+ *
+ * Transport for running the library without hardware. Every module
+ * behaves as PCA9535 with HD44780 and two MCP401x pots attached the way
+ * I2LCD board wires them. HD44780 execution times are enforced: strobe
+ * arriving while controller is busy is counted as violation and dropped.
+ * If bus clock is given, each transfer takes as long as it would on the
+ * wire, so benchmarks show real bus bound throughput.
+ *
+ */
+class SimBus final : public I2CBus
+{
+    private:
+	t_SimModule modules[8];
+	unsigned clock;
+	uint64_t busfree;
+	unsigned long transactions;
+	unsigned long messages;
+	unsigned long bytes;
+	uint64_t wiretime;
+
+	void _reset(t_SimModule &m);
+	void _write(t_SimModule &m, uint8_t reg, uint8_t value);
+	uint8_t _read(t_SimModule &m, uint8_t reg);
+	void _control(t_SimModule &m, uint8_t old, uint8_t value);
+	void _pots(t_SimModule &m, uint8_t old, uint8_t value);
+	void _execute(t_SimModule &m, bool rs, uint8_t value);
+	void _advance(t_SimModule &m);
+
+    public:
+	SimBus(unsigned clockhz = 0, uint8_t busn = 0xff);
+
+	int transfer(struct i2c_msg *msgs, unsigned count);
+
+	const t_SimModule &module(uint8_t address) const { return modules[address & 0x07]; };
+	std::string visible(uint8_t address, const LcdType &type, uint8_t row) const;
+	unsigned long getTransactions(void) const { return transactions; };
+	unsigned long getMessages(void) const { return messages; };
+	unsigned long getBytes(void) const { return bytes; };
+	uint64_t getWireTime(void) const { return wiretime; };
+	void resetCounters(void);
+};
+
+};
+
+#endif
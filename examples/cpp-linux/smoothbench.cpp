@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <framebuffer.h>
+#include <smoothscroll.h>
+
+using namespace i2lcd;
+
+/**
+ * Pixel scrolling of text through 8 cell segment of 16x2 display on
+ * simulated 100 kHz bus. Changed CGRAM bytes per step, unlimited and
+ * with byte budget, are compared with loading whole segment every step.
+ * Last window is drawn from screen copy of the display.
+ *
+ * usage: smoothbench [steps]
+ */
+
+int main(int argc, char **argv)
+{
+    unsigned steps = argc > 1 ? atoi(argv[1]) : 120;
+    unsigned budgets[] = {0, 24, 0};
+    unsigned b, i, sent, most;
+    SimBus bus(100000);
+    I2Lcd lcd(bus, 0x20, D16x2);
+
+    lcd.power(POWERON);
+    printf("mode         bytes/step  max bytes  bus ms/step\n");
+    for (b = 0; b < 3; b++)
+    {
+	SmoothScroll scroll(lcd, 4, 0, 8, 0, budgets[b]);
+
+	scroll.setText("Smooth scrolling 0123456789");
+	scroll.step();
+	bus.resetCounters();
+	most = 0;
+	for (i = 0; i < steps; i++)
+	{
+	    if (b == 2)
+		scroll.redraw();
+	    sent = scroll.step();
+	    if (sent > most)
+		most = sent;
+	}
+	printf("%-12s %10.1f %10u %12.2f\n", b == 2 ? "full" : b ? "budget 24" : "changed", (double) bus.getBytes() / steps,
+	    most, bus.getWireTime() / 1000000.0 / steps);
+    }
+
+    for (uint8_t r = 0; r < 8; r++)
+    {
+	for (uint8_t c = 0; c < 8; c++)
+	{
+	    for (uint8_t x = 0; x < 5; x++)
+		putchar(lcd.getScreen().glyph(c)[r] & (0x10 >> x) ? '#' : '.');
+	    putchar(' ');
+	}
+	putchar('\n');
+    }
+}
@@ -0,0 +1,142 @@
+#include <cstring>
+
+#include <smoothscroll.h>
+
+using namespace i2lcd;
+
+/*
+ * 5x8 font of ASCII 0x20-0x7e, five columns per character,
+ * bit 0 is the top row, bottom row is left for cursor
+ */
+static constexpr uint8_t font[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5f, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+    {0x14, 0x7f, 0x14, 0x7f, 0x14}, {0x24, 0x2a, 0x7f, 0x2a, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1c, 0x22, 0x41, 0x00},
+    {0x00, 0x41, 0x22, 0x1c, 0x00}, {0x08, 0x2a, 0x1c, 0x2a, 0x08}, {0x08, 0x08, 0x3e, 0x08, 0x08},
+    {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3e, 0x51, 0x49, 0x45, 0x3e}, {0x00, 0x42, 0x7f, 0x40, 0x00},
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4b, 0x31}, {0x18, 0x14, 0x12, 0x7f, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3c, 0x4a, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1e}, {0x00, 0x36, 0x36, 0x00, 0x00},
+    {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3e},
+    {0x7e, 0x11, 0x11, 0x11, 0x7e}, {0x7f, 0x49, 0x49, 0x49, 0x36}, {0x3e, 0x41, 0x41, 0x41, 0x22},
+    {0x7f, 0x41, 0x41, 0x22, 0x1c}, {0x7f, 0x49, 0x49, 0x49, 0x41}, {0x7f, 0x09, 0x09, 0x01, 0x01},
+    {0x3e, 0x41, 0x41, 0x51, 0x32}, {0x7f, 0x08, 0x08, 0x08, 0x7f}, {0x00, 0x41, 0x7f, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3f, 0x01}, {0x7f, 0x08, 0x14, 0x22, 0x41}, {0x7f, 0x40, 0x40, 0x40, 0x40},
+    {0x7f, 0x02, 0x04, 0x02, 0x7f}, {0x7f, 0x04, 0x08, 0x10, 0x7f}, {0x3e, 0x41, 0x41, 0x41, 0x3e},
+    {0x7f, 0x09, 0x09, 0x09, 0x06}, {0x3e, 0x41, 0x51, 0x21, 0x5e}, {0x7f, 0x09, 0x19, 0x29, 0x46},
+    {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7f, 0x01, 0x01}, {0x3f, 0x40, 0x40, 0x40, 0x3f},
+    {0x1f, 0x20, 0x40, 0x20, 0x1f}, {0x7f, 0x20, 0x18, 0x20, 0x7f}, {0x63, 0x14, 0x08, 0x14, 0x63},
+    {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7f, 0x41, 0x41, 0x00},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7f, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+    {0x7f, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7f},
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7e, 0x09, 0x01, 0x02}, {0x08, 0x54, 0x54, 0x54, 0x3c},
+    {0x7f, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7d, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3d, 0x00},
+    {0x7f, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7f, 0x40, 0x00}, {0x7c, 0x04, 0x18, 0x04, 0x78},
+    {0x7c, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7c, 0x14, 0x14, 0x14, 0x08},
+    {0x08, 0x14, 0x14, 0x18, 0x7c}, {0x7c, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+    {0x04, 0x3f, 0x44, 0x40, 0x20}, {0x3c, 0x40, 0x40, 0x20, 0x7c}, {0x1c, 0x20, 0x40, 0x20, 0x1c},
+    {0x3c, 0x40, 0x30, 0x40, 0x3c}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0c, 0x50, 0x50, 0x50, 0x3c},
+    {0x44, 0x64, 0x54, 0x4c, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7f, 0x00, 0x00},
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x10, 0x08, 0x08, 0x10, 0x08},
+};
+
+/**
+ * @brief SmoothScroll class constructor
+ *
+ * @param display
+ * @param column left column of the segment, segment off the display draws nothing
+ * @param row
+ * @param cells width of the segment, 1-8
+ * @param slot first CGRAM slot, segment uses slots up to slot + cells - 1
+ * @param budget most CGRAM bytes per step, 0 for 7 bytes per cell
+ **/
+SmoothScroll::SmoothScroll(I2Lcd &display, uint8_t column, uint8_t row, uint8_t cells, uint8_t slot,
+    uint8_t budget) : band(display, column, row, cells, slot)
+{
+    this->budget = budget ? budget : band.cells() * 7;
+    setText("");
+}
+
+/**
+ * @brief Helper setting one pixel column of the text. This method is private
+ **/
+void SmoothScroll::_column(unsigned x, uint8_t pattern)
+{
+    uint8_t r;
+
+    for (r = 0; r < 7; r++)
+	if (pattern & (1 << r))
+	    bits[r][x / 32] |= 0x80000000u >> (x % 32);
+}
+
+/**
+ * @brief Set text, first step shows its start. Characters outside
+ * ASCII are shown as '?', text is cut at SMOOTH_MAX_TEXT characters.
+ *
+ * @param text
+ * @param gap blank characters between end and start of text
+ **/
+void SmoothScroll::setText(const string &text, uint8_t gap)
+{
+    unsigned len = text.size(), n, i, x = 0;
+    uint8_t c, k;
+
+    if (len + gap > SMOOTH_MAX_TEXT)
+	len = gap < SMOOTH_MAX_TEXT ? SMOOTH_MAX_TEXT - gap : 0;
+    n = len + gap ? len + gap : 1;
+    width = n * SMOOTH_PITCH;
+    memset(bits, 0, sizeof(bits));
+
+    /* text, gap and text again until the last window is complete */
+    for (i = 0; x < width + band.cells() * 5; i = (i + 1) % n)
+    {
+	c = i < len ? text[i] : ' ';
+	if (c < 0x20 || c > 0x7e)
+	    c = '?';
+	for (k = 0; k < 5; k++)
+	    _column(x++, font[c - 0x20][k]);
+	x++;
+    }
+    offset = width - 1;
+}
+
+/**
+ * @brief Helper extracting CGRAM bytes of window at offset.
+ * This method is private
+ **/
+void SmoothScroll::_window(char *next) const
+{
+    unsigned w = offset / 32, s = offset % 32;
+    uint64_t v;
+    uint8_t r, c;
+
+    for (r = 0; r < 8; r++)
+    {
+	v = ((uint64_t) bits[r][w] << 32) | bits[r][w + 1];
+	if (s)
+	    v = (v << s) | (bits[r][w + 2] >> (32 - s));
+	for (c = 0; c < band.cells(); c++)
+	    next[c * 8 + r] = (v >> (64 - 5 * (c + 1))) & 0x1f;
+    }
+}
+
+/**
+ * @brief Move text one pixel left and send changed CGRAM bytes,
+ * at most budget of them. First step and step after redraw()
+ * load whole segment and put it into DDRAM.
+ *
+ * @return number of CGRAM bytes sent
+ **/
+unsigned SmoothScroll::step(void)
+{
+    char next[SMOOTH_MAX_CELLS * 8];
+
+    if (!band.cells())
+	return 0;
+    offset = (offset + 1) % width;
+    _window(next);
+    return band.send(next, budget);
+}
@@ -0,0 +1,60 @@
+#ifndef __SMOOTHSCROLL_H__
+#define __SMOOTHSCROLL_H__
+
+#include <cstdint>
+#include <string>
+
+#include <i2lcd.h>
+#include <glyphband.h>
+
+namespace i2lcd {
+
+#define SMOOTH_MAX_CELLS	8
+#define SMOOTH_MAX_TEXT		64
+#define SMOOTH_PITCH		6
+#define SMOOTH_WORDS		((SMOOTH_MAX_TEXT * SMOOTH_PITCH + SMOOTH_MAX_CELLS * 5 + 63) / 32 + 1)
+
+/**
+ * @class SmoothScroll
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Text scrolled by single pixel columns through user characters.
+ *
+ * Segment of up to 8 cells shows user characters, each cell its own
+ * CGRAM slot, and is written to DDRAM once. Text is rasterized with
+ * built in 5x8 font into rows of 32 bit words, followed by a gap and
+ * the start of text again, so the window never wraps. Each step takes
+ * window one pixel further with 64 bit shifts across glyph and word
+ * boundaries, and GlyphBand sends CGRAM bytes which differ from those
+ * loaded. At most budget bytes go out per step, the rest follows in next
+ * steps, so bus time per step is bounded.
+ *
+ */
+class SmoothScroll
+{
+    private:
+	GlyphBand band;
+	uint8_t budget;
+	uint32_t bits[8][SMOOTH_WORDS];
+	unsigned width;
+	unsigned offset;
+
+	void _column(unsigned x, uint8_t pattern);
+	void _window(char *next) const;
+
+    public:
+	SmoothScroll(I2Lcd &display, uint8_t column, uint8_t row, uint8_t cells,
+	    uint8_t slot = 0, uint8_t budget = 0);
+
+	void setText(const string &text, uint8_t gap = 2);
+	unsigned step(void);
+	void redraw(void) { band.redraw(); };
+
+	unsigned getWidth(void) const { return width; };
+	unsigned long getBytes(void) const { return band.getBytes(); };
+};
+
+};
+
+#endif
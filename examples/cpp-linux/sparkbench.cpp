@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <sparkline.h>
+
+using namespace i2lcd;
+
+/**
+ * Load and temperature like trends in 8 and 4 cells wide sparklines on
+ * 20x4 display on simulated 100 kHz bus. Only changed CGRAM bytes are
+ * sent per sample, compared with loading whole band every sample.
+ *
+ * usage: sparkbench [samples]
+ */
+
+int main(int argc, char **argv)
+{
+    unsigned count = argc > 1 ? atoi(argv[1]) : 200;
+    unsigned widths[] = {8, 4};
+    unsigned w, i, mode;
+    int value;
+    SimBus bus(100000);
+    I2Lcd lcd(bus, 0x20, D20x4);
+
+    lcd.power(POWERON);
+    printf("signal       cells  mode         CGRAM bytes/sample  bus bytes/sample  bus ms/sample\n");
+    for (w = 0; w < 2; w++)
+	for (mode = 0; mode < 2; mode++)
+	{
+	    Sparkline spark(lcd, 0, 0, widths[w]);
+	    unsigned long bytes;
+
+	    srand(1);
+	    for (i = 0; i < spark.getSamples(); i++)
+		spark.add(50);
+	    bus.resetCounters();
+	    bytes = spark.getBytes();
+	    value = 50;
+	    for (i = 0; i < count; i++)
+	    {
+		if (w == 0)
+		    value = 50 + (int) (40 * sin(i * 0.05)) + rand() % 9 - 4;
+		else
+		    value = 20 + (i / 40) % 3 * 30;
+		if (mode)
+		    spark.redraw();
+		spark.add(value);
+	    }
+	    printf("%-12s %5u  %-11s %19.1f %17.1f %14.2f\n", w ? "temperature" : "load", widths[w],
+		mode ? "full" : "incremental", (double) (spark.getBytes() - bytes) / count,
+		(double) bus.getBytes() / count, bus.getWireTime() / 1000000.0 / count);
+	}
+}
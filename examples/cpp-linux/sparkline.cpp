@@ -0,0 +1,92 @@
+#include <cstring>
+
+#include <sparkline.h>
+
+using namespace i2lcd;
+
+/**
+ * @brief Sparkline class constructor
+ *
+ * @param display
+ * @param column left column of the band, band off the display draws nothing
+ * @param row
+ * @param cells width of the band in cells, 1-8
+ * @param slot first CGRAM slot, band uses slots up to slot + cells - 1
+ * @param minimum value shown as the lowest pixel
+ * @param maximum value shown as full column
+ **/
+Sparkline::Sparkline(I2Lcd &display, uint8_t column, uint8_t row, uint8_t cells, uint8_t slot, int minimum,
+    int maximum) : band(display, column, row, cells, slot)
+{
+    setRange(minimum, maximum);
+    memset(samples, 0, sizeof(samples));
+}
+
+/**
+ * @brief Set values of the lowest and the highest pixel. Samples
+ * already shown keep their height.
+ *
+ * @param minimum
+ * @param maximum
+ **/
+void Sparkline::setRange(int minimum, int maximum)
+{
+    this->minimum = minimum;
+    this->maximum = maximum > minimum ? maximum : minimum + 1;
+}
+
+/**
+ * @brief Add sample and update the display
+ *
+ * @param value clipped to range
+ **/
+void Sparkline::add(int value)
+{
+    uint8_t n = getSamples();
+
+    if (!n)
+	return;
+    if (value < minimum)
+	value = minimum;
+    if (value > maximum)
+	value = maximum;
+    memmove(samples, samples + 1, n - 1);
+    samples[n - 1] = 1 + ((value - minimum) * (SPARK_HEIGHT - 1) * 2 + (maximum - minimum)) / ((maximum - minimum) * 2);
+    update();
+}
+
+/**
+ * @brief Helper drawing samples into CGRAM bytes of the band,
+ * filled from the bottom. This method is private
+ **/
+void Sparkline::_rasterize(char *bitmap) const
+{
+    uint8_t c, r, x;
+    const uint8_t *s;
+    char bits;
+
+    for (c = 0; c < band.cells(); c++)
+	for (r = 0; r < SPARK_HEIGHT; r++)
+	{
+	    s = samples + c * SPARK_WIDTH;
+	    bits = 0;
+	    for (x = 0; x < SPARK_WIDTH; x++)
+		if (s[x] >= SPARK_HEIGHT - r)
+		    bits |= 0x10 >> x;
+	    bitmap[c * SPARK_HEIGHT + r] = bits;
+	}
+}
+
+/**
+ * @brief Send changed CGRAM bytes. First update and update after
+ * redraw() load all bytes and put the band into DDRAM.
+ **/
+void Sparkline::update(void)
+{
+    char next[SPARK_MAX_CELLS * SPARK_HEIGHT];
+
+    if (!band.cells())
+	return;
+    _rasterize(next);
+    band.send(next);
+}
@@ -0,0 +1,54 @@
+#ifndef __SPARKLINE_H__
+#define __SPARKLINE_H__
+
+#include <cstdint>
+
+#include <i2lcd.h>
+#include <glyphband.h>
+
+namespace i2lcd {
+
+#define SPARK_MAX_CELLS	8
+#define SPARK_WIDTH	5
+#define SPARK_HEIGHT	8
+
+/**
+ * @class Sparkline
+ *
+ * @ingroup i2lcd
+ *
+ * @brief Rolling graph of last samples, one sample per pixel column.
+ *
+ * Band of up to 8 cells shows user characters, each cell its own CGRAM
+ * slot, and is written to DDRAM only once. New sample shifts the pixels
+ * left, the band is rasterized again and GlyphBand sends only runs of
+ * CGRAM bytes which changed.
+ * Every sample has at least one pixel, so the lowest values stay visible.
+ *
+ */
+class Sparkline
+{
+    private:
+	GlyphBand band;
+	int minimum;
+	int maximum;
+	uint8_t samples[SPARK_MAX_CELLS * SPARK_WIDTH];
+
+	void _rasterize(char *bitmap) const;
+
+    public:
+	Sparkline(I2Lcd &display, uint8_t column, uint8_t row, uint8_t cells,
+	    uint8_t slot = 0, int minimum = 0, int maximum = 100);
+
+	void setRange(int minimum, int maximum);
+	void add(int value);
+	void update(void);
+	void redraw(void) { band.redraw(); };
+
+	uint8_t getSamples(void) const { return band.cells() * SPARK_WIDTH; };
+	unsigned long getBytes(void) const { return band.getBytes(); };
+};
+
+};
+
+#endif
@@ -0,0 +1,358 @@
+#include <cstring>
+
+#include <utf8.h>
+
+using namespace i2lcd;
+
+/*
+ * ROM tables, sorted by codepoint. ASCII, Latin-1 of A02 and
+ * halfwidth katakana of A00 are ranges handled in romCode().
+ */
+static constexpr t_RomChar romA00[] = {
+    {0x00a2, 0xec}, {0x00a5, 0x5c}, {0x00b0, 0xdf}, {0x00b5, 0xe4},
+    {0x00df, 0xe2}, {0x00e4, 0xe1}, {0x00f1, 0xee}, {0x00f6, 0xef},
+    {0x00f7, 0xfd}, {0x00fc, 0xf5}, {0x03a3, 0xf6}, {0x03a9, 0xf4},
+    {0x03b1, 0xe0}, {0x03b2, 0xe2}, {0x03b5, 0xe3}, {0x03b8, 0xf2},
+    {0x03bc, 0xe4}, {0x03c0, 0xf7}, {0x03c1, 0xe6}, {0x03c3, 0xe5},
+    {0x2190, 0x7f}, {0x2192, 0x7e}, {0x221a, 0xe8}, {0x221e, 0xf3},
+    {0x2588, 0xff}, {0x4e07, 0xfb}, {0x5186, 0xfc}, {0x5343, 0xfa},
+};
+
+static constexpr t_RomChar romA02[] = {
+    {0x0393, 0x92}, {0x0398, 0x99}, {0x03a3, 0x94}, {0x03a9, 0x9a},
+    {0x03b1, 0x90}, {0x03b4, 0x9b}, {0x03b5, 0x9e}, {0x03c0, 0x93},
+    {0x03c3, 0x95}, {0x03c4, 0x97}, {0x0401, 0xcb}, {0x0411, 0x80},
+    {0x0414, 0x81}, {0x0416, 0x82}, {0x0417, 0x83}, {0x0418, 0x84},
+    {0x0419, 0x85}, {0x041b, 0x86}, {0x041f, 0x87}, {0x0423, 0x88},
+    {0x0426, 0x89}, {0x0427, 0x8a}, {0x0428, 0x8b}, {0x0429, 0x8c},
+    {0x042a, 0x8d}, {0x042b, 0x8e}, {0x042d, 0x8f}, {0x221e, 0x9c},
+    {0x2229, 0x9f}, {0x2665, 0x9d}, {0x266a, 0x91}, {0x266b, 0x96},
+    {0x1f514, 0x98},
+};
+
+/*
+ * Cyrillic capitals looking like latin letters, in both ROMs
+ */
+static constexpr t_RomChar romCommon[] = {
+    {0x0401, 'E'}, {0x0410, 'A'}, {0x0412, 'B'}, {0x0415, 'E'},
+    {0x041a, 'K'}, {0x041c, 'M'}, {0x041d, 'H'}, {0x041e, 'O'},
+    {0x0420, 'P'}, {0x0421, 'C'}, {0x0422, 'T'}, {0x0425, 'X'},
+};
+
+/*
+ * Bitmaps of characters loaded into CGRAM, sorted by codepoint
+ */
+static constexpr t_Glyph builtin[] = {
+    {0x005c, {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00}},
+    {0x007e, {0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00, 0x00}},
+    {0x0411, {0x1f, 0x10, 0x10, 0x1e, 0x11, 0x11, 0x1e, 0x00}},
+    {0x0413, {0x1f, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00}},
+    {0x0414, {0x06, 0x0a, 0x0a, 0x0a, 0x0a, 0x1f, 0x11, 0x00}},
+    {0x0416, {0x15, 0x15, 0x15, 0x0e, 0x15, 0x15, 0x15, 0x00}},
+    {0x0417, {0x0e, 0x11, 0x01, 0x06, 0x01, 0x11, 0x0e, 0x00}},
+    {0x0418, {0x11, 0x11, 0x13, 0x15, 0x19, 0x11, 0x11, 0x00}},
+    {0x0419, {0x0a, 0x04, 0x11, 0x13, 0x15, 0x19, 0x11, 0x00}},
+    {0x041b, {0x07, 0x09, 0x09, 0x09, 0x09, 0x09, 0x11, 0x00}},
+    {0x041f, {0x1f, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x00}},
+    {0x0423, {0x11, 0x11, 0x11, 0x0f, 0x01, 0x11, 0x0e, 0x00}},
+    {0x0424, {0x04, 0x0e, 0x15, 0x15, 0x15, 0x0e, 0x04, 0x00}},
+    {0x0426, {0x12, 0x12, 0x12, 0x12, 0x12, 0x1f, 0x01, 0x00}},
+    {0x0427, {0x11, 0x11, 0x11, 0x0f, 0x01, 0x01, 0x01, 0x00}},
+    {0x0428, {0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x1f, 0x00}},
+    {0x0429, {0x15, 0x15, 0x15, 0x15, 0x15, 0x1f, 0x01, 0x00}},
+    {0x042a, {0x18, 0x08, 0x08, 0x0e, 0x09, 0x09, 0x0e, 0x00}},
+    {0x042b, {0x11, 0x11, 0x11, 0x19, 0x15, 0x15, 0x19, 0x00}},
+    {0x042c, {0x10, 0x10, 0x10, 0x1e, 0x11, 0x11, 0x1e, 0x00}},
+    {0x042d, {0x0e, 0x11, 0x01, 0x07, 0x01, 0x11, 0x0e, 0x00}},
+    {0x042e, {0x12, 0x15, 0x15, 0x1d, 0x15, 0x15, 0x12, 0x00}},
+    {0x042f, {0x0f, 0x11, 0x11, 0x0f, 0x05, 0x09, 0x11, 0x00}},
+    {0x20ac, {0x07, 0x08, 0x1e, 0x08, 0x1e, 0x08, 0x07, 0x00}},
+};
+
+/**
+ * @brief Helper searching sorted table
+ */
+template <typename T, size_t N>
+static const T *_find(const T (&table)[N], uint32_t codepoint)
+{
+    size_t lo = 0, hi = N, mid;
+
+    while (lo < hi)
+    {
+	mid = (lo + hi) / 2;
+	if (table[mid].codepoint < codepoint)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    return lo < N && table[lo].codepoint == codepoint ? &table[lo] : NULL;
+}
+
+/**
+ * @brief Utf8Mapper class constructor
+ *
+ * @param rom character ROM of the display
+ * @param first first CGRAM slot the mapper may use
+ * @param count number of slots
+ **/
+Utf8Mapper::Utf8Mapper(t_CharRom rom, uint8_t first, uint8_t count) : rom(rom), replacement('?'), defined(0),
+    tick(1), loads(0), replaced(0)
+{
+    this->first = first & 0x07;
+    this->count = count < 8 - this->first ? count : 8 - this->first;
+    memset(slots, 0, sizeof(slots));
+}
+
+/**
+ * @brief Decode one character and move pointer past it.
+ * Malformed sequence, overlong form and surrogate give U+FFFD
+ * and skip single byte.
+ *
+ * @param p position in text
+ * @param end end of text, p must be before it
+ * @return codepoint
+ **/
+uint32_t Utf8Mapper::decode(const char *&p, const char *end)
+{
+    const uint8_t *s = (const uint8_t *) p;
+    uint32_t cp;
+    int n, i;
+
+    if (s[0] < 0x80)
+    {
+	p++;
+	return s[0];
+    }
+    if (s[0] >= 0xc2 && s[0] <= 0xdf)
+    {
+	n = 1;
+	cp = s[0] & 0x1f;
+    } else if (s[0] >= 0xe0 && s[0] <= 0xef)
+    {
+	n = 2;
+	cp = s[0] & 0x0f;
+    } else if (s[0] >= 0xf0 && s[0] <= 0xf4)
+    {
+	n = 3;
+	cp = s[0] & 0x07;
+    } else
+    {
+	p++;
+	return UTF8_REPLACEMENT;
+    }
+    if (end - p <= n)
+    {
+	p++;
+	return UTF8_REPLACEMENT;
+    }
+    for (i = 1; i <= n; i++)
+    {
+	if ((s[i] & 0xc0) != 0x80)
+	{
+	    p++;
+	    return UTF8_REPLACEMENT;
+	}
+	cp = (cp << 6) | (s[i] & 0x3f);
+    }
+    if ((n == 2 && (cp < 0x800 || (cp >= 0xd800 && cp <= 0xdfff))) || (n == 3 && (cp < 0x10000 || cp > 0x10ffff)))
+    {
+	p++;
+	return UTF8_REPLACEMENT;
+    }
+    p += n + 1;
+    return cp;
+}
+
+/**
+ * @brief ROM code of character
+ *
+ * @param rom
+ * @param codepoint
+ * @return code, -1 when ROM doesn't have it
+ **/
+int Utf8Mapper::romCode(t_CharRom rom, uint32_t codepoint)
+{
+    const t_RomChar *c;
+
+    if (codepoint < 0x20)
+	return ' ';
+    if (rom == ROM_A00)
+    {
+	if (codepoint < 0x7e && codepoint != 0x5c)
+	    return codepoint;
+	if (codepoint >= 0xff61 && codepoint <= 0xff9f)
+	    return codepoint - 0xff61 + 0xa1;
+	c = _find(romA00, codepoint);
+    } else
+    {
+	if (codepoint < 0x7f || (codepoint >= 0xa0 && codepoint <= 0xff))
+	    return codepoint;
+	c = _find(romA02, codepoint);
+    }
+    if (!c)
+	c = _find(romCommon, codepoint);
+    return c ? c->code : -1;
+}
+
+/**
+ * @brief Fold character missing in ROM to one which may be there,
+ * small cyrillic letters become capitals
+ *
+ * @param codepoint
+ * @return folded codepoint
+ **/
+uint32_t Utf8Mapper::fold(uint32_t codepoint)
+{
+    if (codepoint >= 0x0430 && codepoint <= 0x044f)
+	return codepoint - 0x20;
+    if (codepoint == 0x0451)
+	return 0x0401;
+    return codepoint;
+}
+
+/**
+ * @brief Define bitmap of character, replacing built in one
+ *
+ * @param codepoint
+ * @param bitmap 8 bytes
+ * @return false when there's no room for more characters
+ **/
+bool Utf8Mapper::define(uint32_t codepoint, const char *bitmap)
+{
+    uint8_t i;
+
+    for (i = 0; i < defined && glyphs[i].codepoint != codepoint; i++)
+	;
+    if (i == UTF8_USER_GLYPHS)
+	return false;
+    if (i == defined)
+	defined++;
+    glyphs[i].codepoint = codepoint;
+    memcpy(glyphs[i].bitmap, bitmap, 8);
+    for (i = first; i < first + count; i++)
+	if (slots[i].codepoint == codepoint)
+	    slots[i].codepoint = slots[i].used = 0;
+    return true;
+}
+
+/**
+ * @brief Start mapping of new frame, slots used so far are unpinned
+ **/
+void Utf8Mapper::begin(void)
+{
+    tick++;
+}
+
+/**
+ * @brief Helper returning bitmap of character. This method is private
+ **/
+const char *Utf8Mapper::_bitmap(uint32_t codepoint) const
+{
+    const t_Glyph *g;
+    uint8_t i;
+
+    for (i = 0; i < defined; i++)
+	if (glyphs[i].codepoint == codepoint)
+	    return glyphs[i].bitmap;
+    g = _find(builtin, codepoint);
+    return g ? g->bitmap : NULL;
+}
+
+/**
+ * @brief Helper finding or loading CGRAM slot of character.
+ * This method is private
+ **/
+int Utf8Mapper::_slot(uint32_t codepoint, FrameBuffer &frame)
+{
+    const char *bitmap;
+    int victim = -1;
+    uint8_t i;
+
+    for (i = first; i < first + count; i++)
+	if (slots[i].codepoint == codepoint)
+	{
+	    slots[i].used = tick;
+	    return i;
+	}
+    bitmap = _bitmap(codepoint);
+    if (!bitmap)
+	return -1;
+    for (i = first; i < first + count; i++)
+	if (slots[i].used != tick && (victim < 0 || slots[i].used < slots[victim].used))
+	    victim = i;
+    if (victim < 0)
+	return -1;
+    frame.setGC(victim, bitmap);
+    slots[victim].codepoint = codepoint;
+    slots[victim].used = tick;
+    loads++;
+    return victim;
+}
+
+/**
+ * @brief Map character to display code, loading its bitmap when needed
+ *
+ * @param codepoint
+ * @param frame frame receiving loaded bitmaps
+ * @return code for DDRAM
+ **/
+char Utf8Mapper::map(uint32_t codepoint, FrameBuffer &frame)
+{
+    int code;
+
+    code = romCode(rom, codepoint);
+    if (code < 0)
+    {
+	codepoint = fold(codepoint);
+	code = romCode(rom, codepoint);
+    }
+    if (code < 0)
+	code = _slot(codepoint, frame);
+    if (code < 0)
+    {
+	replaced++;
+	return replacement;
+    }
+    return code;
+}
+
+/**
+ * @brief Map UTF-8 text into display codes
+ *
+ * @param text
+ * @param len bytes of text
+ * @param out output buffer
+ * @param size size of output buffer, the rest of text is skipped
+ * @param frame frame receiving loaded bitmaps
+ * @return number of codes
+ **/
+unsigned Utf8Mapper::encode(const char *text, size_t len, char *out, unsigned size, FrameBuffer &frame)
+{
+    const char *end = text + len;
+    unsigned n = 0;
+
+    while (text < end && n < size)
+	out[n++] = map(decode(text, end), frame);
+    return n;
+}
+
+/**
+ * @brief Put UTF-8 text into frame, clipped at the end of the row
+ *
+ * @param frame
+ * @param column
+ * @param row
+ * @param text zero terminated
+ * @return number of cells written
+ **/
+unsigned Utf8Mapper::print(FrameBuffer &frame, uint8_t column, uint8_t row, const char *text)
+{
+    char buf[FB_MAX_COLUMNS];
+    unsigned n;
+
+    if (row >= frame.rows() || column >= frame.columns())
+	return 0;
+    n = encode(text, strlen(text), buf, frame.columns() - column, frame);
+    frame.put(column, row, buf, n);
+    return n;
+}
@@ -0,0 +1,100 @@
+#ifndef __UTF8_H__
+#define __UTF8_H__
+
+#include <cstdint>
+#include <cstddef>
+
+#include <framebuffer.h>
+
+namespace i2lcd {
+
+#define UTF8_REPLACEMENT	0xfffd
+#define UTF8_USER_GLYPHS	16
+
+/**
+ * @brief HD44780 character ROM: A00 Japanese, A02 European
+ */
+enum t_CharRom {
+    ROM_A00,
+    ROM_A02,
+};
+
+/**
+ * @brief Character of ROM table: codepoint and its ROM code
+ */
+struct t_RomChar {
+    uint32_t codepoint;
+    uint8_t code;
+};
+
+/**
+ * @brief 5x8 bitmap of character missing in ROM
+ */
+struct t_Glyph {
+    uint32_t codepoint;
+    char bitmap[8];
+};
+
+/**
+ * @class Utf8Mapper
+ *
+ * @ingroup i2lcd
+ *
+ * @brief UTF-8 text mapped to character ROM and user characters.
+ *
+ * Codepoints found in ROM table are replaced by their ROM codes. Cyrillic
+ * letters are shown in capitals and those looking like latin letters use
+ * latin codes. Other characters with known bitmap, built in or given with
+ * define(), are loaded into CGRAM slots of the frame on demand. Slots are
+ * taken in least recently used order, slot used since last begin() is
+ * pinned and won't be reused until next begin(). When every slot is
+ * pinned or there is no bitmap, replacement character is shown.
+ *
+ * Decoding and mapping use fixed tables and caller buffers, nothing is
+ * allocated, so whole frame can be mapped on every refresh: call begin(),
+ * then print() all text of the frame and show it.
+ *
+ */
+class Utf8Mapper
+{
+    private:
+	struct t_Slot {
+	    uint32_t codepoint;
+	    uint32_t used;
+	};
+
+	t_CharRom rom;
+	uint8_t first;
+	uint8_t count;
+	char replacement;
+	t_Slot slots[8];
+	t_Glyph glyphs[UTF8_USER_GLYPHS];
+	uint8_t defined;
+	uint32_t tick;
+	unsigned long loads;
+	unsigned long replaced;
+
+	const char *_bitmap(uint32_t codepoint) const;
+	int _slot(uint32_t codepoint, FrameBuffer &frame);
+
+    public:
+	Utf8Mapper(t_CharRom rom = ROM_A00, uint8_t first = 0, uint8_t count = 8);
+
+	void setReplacement(char c) { replacement = c; };
+	bool define(uint32_t codepoint, const char *bitmap);
+	void begin(void);
+	char map(uint32_t codepoint, FrameBuffer &frame);
+	unsigned encode(const char *text, size_t len, char *out, unsigned size, FrameBuffer &frame);
+	unsigned print(FrameBuffer &frame, uint8_t column, uint8_t row, const char *text);
+
+	unsigned long getLoads(void) const { return loads; };
+	unsigned long getReplaced(void) const { return replaced; };
+
+	static uint32_t decode(const char *&p, const char *end);
+	static int romCode(t_CharRom rom, uint32_t codepoint);
+	static uint32_t fold(uint32_t codepoint);
+};
+
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+#include <framebuffer.h>
+#include <utf8.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Mapping of 20x4 frames of UTF-8 text on both character ROMs. Reports
+ * time per character, glyphs loaded into CGRAM and replaced characters
+ * per frame, and codes of the first frame, characters outside ASCII
+ * in hex.
+ *
+ * usage: utf8bench [frames]
+ */
+
+static const char *texts[][4] = {
+    {"Grüße aus München", "Außen 23°C  € 4,20", "Привет, мир!", "ﾃﾞｨｽﾌﾟﾚｲ ¥1200 → OK"},
+    {"Температура 21°C", "Влажность 45 %", "Давление 1013 гПа", "Ёлки: ЖЗИЙ ФЦЧШЩ"},
+};
+
+static void _dump(const FrameBuffer &frame)
+{
+    uint8_t r, c;
+    unsigned char ch;
+
+    for (r = 0; r < frame.rows(); r++)
+    {
+	printf("  |");
+	for (c = 0; c < frame.columns(); c++)
+	{
+	    ch = frame.at(c, r);
+	    if (ch >= 0x20 && ch < 0x7f)
+		putchar(ch);
+	    else
+		printf("\\x%02x", ch);
+	}
+	printf("|\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned frames = argc > 1 ? atoi(argv[1]) : 100000;
+    const char *names[] = {"A00", "A02"};
+    unsigned r, t, f;
+    unsigned long chars;
+    double ns;
+
+    for (r = 0; r < 2; r++)
+	for (t = 0; t < 2; t++)
+	{
+	    Utf8Mapper mapper((t_CharRom) r);
+	    FrameBuffer frame(20, 4);
+	    unsigned long replaced;
+
+	    chars = 0;
+	    steady_clock::time_point start = steady_clock::now();
+	    for (f = 0; f < frames; f++)
+	    {
+		mapper.begin();
+		for (uint8_t i = 0; i < 4; i++)
+		    chars += mapper.print(frame, 0, i, texts[t][i]);
+		if (!f)
+		    replaced = mapper.getReplaced();
+	    }
+	    ns = duration<double, std::nano>(steady_clock::now() - start).count();
+	    printf("ROM %s text %u: %.1f ns/char, %lu glyph loads in %u frames, %lu replaced per frame\n", names[r], t,
+		ns / chars, mapper.getLoads(), frames, replaced);
+	    _dump(frame);
+	}
+}
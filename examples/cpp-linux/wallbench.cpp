@@ -0,0 +1,110 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include <i2lcd.h>
+#include <simbus.h>
+#include <scheduler.h>
+#include <buspool.h>
+
+using namespace i2lcd;
+using namespace std::chrono;
+
+/**
+ * Refresh time of a display wall: several simulated 100 kHz buses with
+ * 20x4 displays each. Every round all displays get a new frame. Compared
+ * are one thread serving buses one after another, and BusPool with
+ * a worker per bus, where round takes as long as the slowest bus.
+ *
+ * usage: wallbench [buses] [displays per bus] [rounds]
+ */
+
+static void _compose(FrameBuffer &frame, unsigned display, unsigned round)
+{
+    char line[32];
+    unsigned row;
+
+    for (row = 0; row < 4; row++)
+    {
+	snprintf(line, sizeof(line), "D%02u R%u value %6u", display, row, round * 7 + row * 13 + display);
+	frame.print(0, row, line);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned nbus = argc > 1 ? atoi(argv[1]) : 4;
+    unsigned per = argc > 2 ? atoi(argv[2]) : 4;
+    unsigned rounds = argc > 3 ? atoi(argv[3]) : 10;
+    std::vector<SimBus*> buses;
+    std::vector<I2Lcd*> lcds;
+    std::vector<FrameBuffer> frames(nbus * per, FrameBuffer(20, 4));
+    std::vector<const FrameBuffer*> wall;
+    unsigned b, i, r;
+    double t;
+
+    for (b = 0; b < nbus; b++)
+    {
+	buses.push_back(new SimBus(100000, b));
+	for (i = 0; i < per; i++)
+	{
+	    lcds.push_back(new I2Lcd(*buses[b], 0x20 + i, D20x4));
+	    lcds.back()->power(POWERON);
+	}
+    }
+    for (i = 0; i < frames.size(); i++)
+	wall.push_back(&frames[i]);
+
+    printf("buses  displays  mode      ms/refresh\n");
+    {
+	std::vector<BusScheduler*> scheds;
+
+	for (b = 0; b < nbus; b++)
+	{
+	    scheds.push_back(new BusScheduler(*buses[b]));
+	    for (i = 0; i < per; i++)
+		scheds[b]->attach(*lcds[b * per + i]);
+	}
+	steady_clock::time_point start = steady_clock::now();
+	for (r = 0; r < rounds; r++)
+	    for (b = 0; b < nbus; b++)
+	    {
+		for (i = 0; i < per; i++)
+		{
+		    _compose(frames[b * per + i], b * per + i, r);
+		    scheds[b]->show(i, frames[b * per + i]);
+		}
+		scheds[b]->run();
+	    }
+	t = duration<double>(steady_clock::now() - start).count();
+	printf("%5u  %8u  %-8s %11.2f\n", nbus, nbus * per, "serial", t * 1000 / rounds);
+	for (b = 0; b < nbus; b++)
+	    delete scheds[b];
+    }
+
+    {
+	BusPool pool;
+
+	for (b = 0; b < nbus; b++)
+	{
+	    pool.addBus(*buses[b]);
+	    for (i = 0; i < per; i++)
+		pool.attach(b, *lcds[b * per + i]);
+	}
+	steady_clock::time_point start = steady_clock::now();
+	for (r = 0; r < rounds; r++)
+	{
+	    for (i = 0; i < frames.size(); i++)
+		_compose(frames[i], i, r + rounds);
+	    pool.submit(wall)->wait();
+	}
+	t = duration<double>(steady_clock::now() - start).count();
+	printf("%5u  %8u  %-8s %11.2f\n", nbus, nbus * per, "pool", t * 1000 / rounds);
+    }
+
+    for (i = 0; i < lcds.size(); i++)
+	delete lcds[i];
+    for (b = 0; b < nbus; b++)
+	delete buses[b];
+}